@@ -32,58 +32,74 @@ struct Entry
   std::vector<double> values;
 };
 
-std::vector<Entry> read_entries(std::istream& input)
+ControlRowReader::ControlRowReader(std::istream& input)
+  : input(input),
+    num_controls(0),
+    num_rows(0)
 {
   if(!input)
   {
     throw std::invalid_argument("Invalid input");
   }
+}
 
+bool ControlRowReader::read(Point& point, Controls& controls)
+{
   std::string line;
 
-  idx line_number = 1;
+  if(!std::getline(input, line))
+  {
+    return false;
+  }
 
-  idx num_controls = 0;
+  std::vector<std::string> tokens = tokenize(line);
 
-  bool first_line = true;
+  if(tokens.size() <= 2)
+  {
+    throw std::invalid_argument("Insufficient number of tokens");
+  }
 
-  std::vector<Entry> entries;
+  const double i = std::stod(tokens[0]);
+  const double j = std::stod(tokens[1]);
 
-  while(std::getline(input, line))
+  controls.clear();
+
+  for(idx k = 2; k < tokens.size(); ++k)
   {
-    std::vector<std::string> tokens = tokenize(line);
+    controls.push_back(std::stod(tokens[k]));
+  }
 
-    if(tokens.size() <= 2)
+  if(num_rows == 0)
+  {
+    num_controls = controls.size();
+  }
+  else
+  {
+    if(num_controls != controls.size())
     {
-      throw std::invalid_argument("Insufficient number of tokens");
+      throw std::invalid_argument("Invalid number of tokens");
     }
+  }
 
-    const double i = std::stod(tokens[0]);
-    const double j = std::stod(tokens[1]);
+  point = Point((idx) i, (idx) j);
 
-    std::vector<double> controls;
+  ++num_rows;
 
-    for(idx k = 2; k < tokens.size(); ++k)
-    {
-      controls.push_back(std::stod(tokens[k]));
-    }
+  return true;
+}
 
-    if(first_line)
-    {
-      num_controls = controls.size();
-    }
-    else
-    {
-      if(num_controls != controls.size())
-      {
-        throw std::invalid_argument("Invalid number of tokens");
-      }
-    }
+std::vector<Entry> read_entries(std::istream& input)
+{
+  ControlRowReader reader(input);
+
+  std::vector<Entry> entries;
 
-    entries.push_back(Entry{(idx) i, (idx) j, controls});
+  Point point;
+  Controls controls;
 
-    ++line_number;
-    first_line = false;
+  while(reader.read(point, controls))
+  {
+    entries.push_back(Entry{point.get_i(), point.get_j(), controls});
   }
 
   Log(debug) << "Read " << entries.size() << " entries";
@@ -184,3 +200,64 @@ ReadResult read_file(std::istream& input)
 
   return ReadResult{graph, fractional_controls, points_by_vertices};
 }
+
+VertexMap<Controls> read_controls(std::istream& input,
+                                  const Graph& graph,
+                                  const VertexMap<Point>& coordinates)
+{
+  ControlRowReader reader(input);
+
+  VertexMap<Controls> fractional_controls(graph, {});
+
+  Point point;
+  Controls controls;
+
+  for(const Vertex& vertex : graph.get_vertices())
+  {
+    if(!reader.read(point, controls) || !(point == coordinates(vertex)))
+    {
+      throw std::invalid_argument("Input does not match the grid");
+    }
+
+    if(!controls_are_convex(controls))
+    {
+      throw std::invalid_argument("Controls are not convex");
+    }
+
+    fractional_controls(vertex) = controls;
+  }
+
+  if(reader.read(point, controls))
+  {
+    throw std::invalid_argument("Input does not match the grid");
+  }
+
+  Log(debug) << "Read " << reader.get_num_rows() << " entries";
+
+  return fractional_controls;
+}
+
+const ReadResult& SequenceReader::read(std::istream& input)
+{
+  if(!result)
+  {
+    result = read_file(input);
+
+    return *result;
+  }
+
+  VertexMap<Controls> fractional_controls = read_controls(input,
+                                                          result->graph,
+                                                          result->coordinates);
+
+  const Vertex source = *result->graph.get_vertices().begin();
+
+  if(fractional_controls(source).size() != result->fractional_controls(source).size())
+  {
+    throw std::invalid_argument("Dimension does not match");
+  }
+
+  result->fractional_controls = fractional_controls;
+
+  return *result;
+}
@@ -2,6 +2,7 @@
 #define CONTROL_READER_HH
 
 #include <fstream>
+#include <optional>
 
 #include "controls.hh"
 #include "point.hh"
@@ -17,4 +18,77 @@ struct ReadResult
 
 ReadResult read_file(std::istream& input);
 
+/**
+ * Reads the rows of an input file one at a time, i.e., the
+ * coordinates and fractional controls of the vertices in their
+ * order, without constructing a Graph.
+ **/
+class ControlRowReader
+{
+private:
+  std::istream& input;
+  idx num_controls;
+  idx num_rows;
+
+public:
+  /**
+   * Constructs a new ControlRowReader. Throws an
+   * std::invalid_argument if the input is invalid.
+   **/
+  ControlRowReader(std::istream& input);
+
+  /**
+   * Reads the next row, returning false at the end of the
+   * input. Throws an std::invalid_argument if the row is malformed
+   * or its number of controls differs from the previous rows.
+   **/
+  bool read(Point& point, Controls& controls);
+
+  idx get_num_rows() const
+  {
+    return num_rows;
+  }
+};
+
+/**
+ * Reads the fractional controls of an input defined on the given
+ * Graph (i.e., whose rows have the given coordinates in the order of
+ * the vertices), without constructing another Graph. Throws an
+ * std::invalid_argument if the input does not match the Graph
+ * or the controls are not convex.
+ **/
+VertexMap<Controls> read_controls(std::istream& input,
+                                  const Graph& graph,
+                                  const VertexMap<Point>& coordinates);
+
+/**
+ * Reads a sequence of inputs defined on the same grid, e.g., the
+ * fractional controls of consecutive time steps: The Graph is only
+ * constructed for the first input, the fractional controls of
+ * subsequent inputs are read into the existing ReadResult.
+ **/
+class SequenceReader
+{
+private:
+  std::optional<ReadResult> result;
+
+public:
+  /**
+   * Reads the next input. The returned ReadResult (including
+   * its Graph) remains valid until the reader is reset. Throws an
+   * std::invalid_argument if the input does not match the grid
+   * or the dimension of the first input.
+   **/
+  const ReadResult& read(std::istream& input);
+
+  /**
+   * Resets the reader, such that the next input
+   * may be defined on a different grid.
+   **/
+  void reset()
+  {
+    result.reset();
+  }
+};
+
 #endif /* CONTROL_READER_HH */
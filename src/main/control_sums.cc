@@ -0,0 +1,159 @@
+#include "control_sums.hh"
+
+#include <cmath>
+#include <stdexcept>
+
+std::optional<std::size_t>
+SumLayer::encode(const std::vector<idx>& control_sums) const
+{
+  std::size_t code = 0;
+
+  for(idx k = 0; k < control_sums.size(); ++k)
+  {
+    if(control_sums[k] < lower[k] ||
+       control_sums[k] >= lower[k] + radices[k])
+    {
+      return {};
+    }
+
+    code += (control_sums[k] - lower[k]) * multipliers[k];
+  }
+
+  return code;
+}
+
+std::vector<idx> SumLayer::decode(std::size_t code) const
+{
+  std::vector<idx> control_sums(lower.size());
+
+  for(idx k = 0; k < lower.size(); ++k)
+  {
+    control_sums[k] = lower[k] + (code / multipliers[k]) % radices[k];
+  }
+
+  return control_sums;
+}
+
+std::vector<SumLayer> compute_sum_layers(const Graph& graph,
+                                         const VertexMap<Controls>& fractional_controls,
+                                         double upper_bound)
+{
+  const Vertex source = *graph.get_vertices().begin();
+  const idx dimension = fractional_controls(source).size();
+
+  std::vector<SumLayer> sum_layers;
+
+  sum_layers.reserve(graph.get_vertices().size());
+
+  std::vector<double> fractional_control_sums(dimension, 0.);
+
+  idx num_vertices = 0;
+
+  for(const Vertex& vertex : graph.get_vertices())
+  {
+    ++num_vertices;
+
+    SumLayer sum_layer{{}, {}, {}, 1};
+
+    for(idx k = 0; k < dimension; ++k)
+    {
+      fractional_control_sums.at(k) += fractional_controls(vertex).at(k);
+
+      const double fractional_control_sum = fractional_control_sums.at(k);
+
+      const double lower = std::max(std::ceil(fractional_control_sum - upper_bound), 0.);
+      const double upper = std::min(std::floor(fractional_control_sum + upper_bound),
+                                    (double) num_vertices);
+
+      if(lower > upper)
+      {
+        throw std::invalid_argument("Instance is infeasible");
+      }
+
+      const idx radix = (idx) (upper - lower) + 1;
+
+      sum_layer.lower.push_back((idx) lower);
+      sum_layer.radices.push_back(radix);
+      sum_layer.multipliers.push_back(sum_layer.size);
+
+      sum_layer.size *= radix;
+    }
+
+    sum_layers.push_back(sum_layer);
+  }
+
+  return sum_layers;
+}
+
+SumOracle::SumOracle(const Graph& graph,
+                     const VertexMap<Controls>& fractional_controls,
+                     double upper_bound)
+  : sum_layers(compute_sum_layers(graph, fractional_controls, upper_bound)),
+    viable_sums(sum_layers.size())
+{
+  const idx num_layers = sum_layers.size();
+
+  if(num_layers == 0)
+  {
+    return;
+  }
+
+  viable_sums.back().assign(sum_layers.back().size, true);
+
+  for(idx index = num_layers - 1; index-- > 0;)
+  {
+    const SumLayer& sum_layer = sum_layers[index];
+    const SumLayer& next_layer = sum_layers[index + 1];
+
+    const std::vector<bool>& next_viable = viable_sums[index + 1];
+
+    std::vector<bool>& viable = viable_sums[index];
+
+    viable.assign(sum_layer.size, false);
+
+    for(std::size_t sum_code = 0; sum_code < sum_layer.size; ++sum_code)
+    {
+      std::vector<idx> control_sums = sum_layer.decode(sum_code);
+
+      for(idx i = 0; i < control_sums.size(); ++i)
+      {
+        ++control_sums[i];
+
+        auto next_sum_code = next_layer.encode(control_sums);
+
+        --control_sums[i];
+
+        if(next_sum_code && next_viable[*next_sum_code])
+        {
+          viable[sum_code] = true;
+          break;
+        }
+      }
+    }
+  }
+
+  bool initially_viable = false;
+
+  std::vector<idx> control_sums(sum_layers.front().lower.size(), 0);
+
+  for(idx i = 0; i < control_sums.size(); ++i)
+  {
+    control_sums[i] = 1;
+
+    initially_viable = initially_viable || is_viable(0, control_sums);
+
+    control_sums[i] = 0;
+  }
+
+  if(!initially_viable)
+  {
+    throw std::invalid_argument("Instance is infeasible");
+  }
+}
+
+bool SumOracle::is_viable(idx index, const std::vector<idx>& control_sums) const
+{
+  auto sum_code = sum_layers.at(index).encode(control_sums);
+
+  return sum_code && viable_sums[index][*sum_code];
+}
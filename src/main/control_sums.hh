@@ -0,0 +1,76 @@
+#ifndef CONTROL_SUMS_HH
+#define CONTROL_SUMS_HH
+
+#include <optional>
+#include <vector>
+
+#include "controls.hh"
+#include "util.hh"
+#include "graph/graph.hh"
+#include "graph/vertex_map.hh"
+
+/**
+ * The feasible control sums after a given number of vertices, i.e.,
+ * the integral control sums which deviate by at most the upper bound
+ * from the fractional control sums. The control sums are
+ * encoded in a mixed radix system.
+ **/
+struct SumLayer
+{
+  std::vector<idx> lower;
+  std::vector<idx> radices;
+  std::vector<std::size_t> multipliers;
+  std::size_t size;
+
+  /**
+   * Returns the code of the given control sums if they are feasible.
+   **/
+  std::optional<std::size_t> encode(const std::vector<idx>& control_sums) const;
+
+  std::vector<idx> decode(std::size_t code) const;
+};
+
+/**
+ * Returns the feasible control sums with respect to
+ * all prefixes of the vertices of the given Graph. Throws an
+ * std::invalid_argument if there are no feasible sums for some prefix.
+ **/
+std::vector<SumLayer> compute_sum_layers(const Graph& graph,
+                                         const VertexMap<Controls>& fractional_controls,
+                                         double upper_bound);
+
+/**
+ * Decides whether given control sums can be completed to a feasible
+ * solution, i.e., whether a control can be assigned to each of the
+ * remaining vertices such that all subsequent control sums are
+ * feasible as well. The viable sums are computed in a backward
+ * pass over the SumLayer%s (disregarding vanishing constraints).
+ **/
+class SumOracle
+{
+private:
+  std::vector<SumLayer> sum_layers;
+  std::vector<std::vector<bool>> viable_sums;
+
+public:
+  /**
+   * Constructs a new SumOracle. Throws an std::invalid_argument
+   * if the instance is infeasible.
+   **/
+  SumOracle(const Graph& graph,
+            const VertexMap<Controls>& fractional_controls,
+            double upper_bound);
+
+  const std::vector<SumLayer>& get_sum_layers() const
+  {
+    return sum_layers;
+  }
+
+  /**
+   * Returns whether the control sums after the vertex with the
+   * given index are viable.
+   **/
+  bool is_viable(idx index, const std::vector<idx>& control_sums) const;
+};
+
+#endif /* CONTROL_SUMS_HH */
@@ -9,15 +9,23 @@ void write_controls(const Graph& graph,
 {
   for(const Vertex& vertex: graph.get_vertices())
   {
-    Point point = coordinates(vertex);
-
-    out << point.get_i() << "," << point.get_j();
+    write_control_row(coordinates(vertex),
+                      controls(vertex),
+                      out);
+  }
+}
 
-    for(const double& value : controls(vertex))
-    {
-      out << "," << std::fixed << value;
-    }
+void write_control_row(const Point& point,
+                       const Controls& controls,
+                       std::ostream& out)
+{
+  out << point.get_i() << "," << point.get_j();
 
-    out << std::endl;
+  for(const double& value : controls)
+  {
+    out << "," << std::fixed << value;
   }
+
+  // avoid flushing each row of large (streamed) outputs
+  out << '\n';
 }
@@ -13,4 +13,12 @@ void write_controls(const Graph& graph,
                     VertexMap<Point> coordinates,
                     std::ostream& out);
 
+/**
+ * Writes the controls of a single vertex in the
+ * format of write_controls().
+ **/
+void write_control_row(const Point& point,
+                       const Controls& controls,
+                       std::ostream& out);
+
 #endif /* CONTROL_WRITER_HH */
@@ -30,25 +30,31 @@ bool controls_are_integral(const Graph& graph,
   return true;
 }
 
-bool controls_are_convex(const Graph& graph,
-                         const VertexMap<Controls>& controls,
+bool controls_are_convex(const Controls& controls,
                          double eps)
 {
-  for(const Vertex& vertex : graph.get_vertices())
-  {
-    double sum = 0.;
+  double sum = 0.;
 
-    for(const double& value : controls(vertex))
+  for(const double& value : controls)
+  {
+    if(cmp::neg(value, eps))
     {
-      if(cmp::neg(value, eps))
-      {
-        return false;
-      }
-
-      sum += value;
+      return false;
     }
 
-    if(!cmp::eq(sum, 1., eps))
+    sum += value;
+  }
+
+  return cmp::eq(sum, 1., eps);
+}
+
+bool controls_are_convex(const Graph& graph,
+                         const VertexMap<Controls>& controls,
+                         double eps)
+{
+  for(const Vertex& vertex : graph.get_vertices())
+  {
+    if(!controls_are_convex(controls(vertex), eps))
     {
       return false;
     }
@@ -17,6 +17,13 @@ bool controls_are_integral(const Graph& graph,
                            const VertexMap<Controls>& controls,
                            double eps = cmp::eps);
 
+/**
+ * Returns whether the controls of a single vertex are
+ * non-negative and sum up to one.
+ **/
+bool controls_are_convex(const Controls& controls,
+                         double eps = cmp::eps);
+
 bool controls_are_convex(const Graph& graph,
                          const VertexMap<Controls>& controls,
                          double eps = cmp::eps);
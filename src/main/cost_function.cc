@@ -44,3 +44,42 @@ double CostFunction::evaluate(const Graph& graph,
 
   return total_value;
 }
+
+EdgeMap<std::vector<double>> tabulate_costs(const Graph& graph,
+                                            const CostFunction& costs,
+                                            idx dimension)
+{
+  EdgeMap<std::vector<double>> cost_tables(graph, {});
+
+  Controls source_controls(dimension, 0.);
+  Controls target_controls(dimension, 0.);
+
+  for(const Edge& edge : graph.get_edges())
+  {
+    auto& cost_table = cost_tables(edge);
+
+    cost_table.resize(dimension * dimension);
+
+    for(idx i = 0; i < dimension; ++i)
+    {
+      source_controls.at(i) = 1.;
+
+      for(idx j = 0; j < dimension; ++j)
+      {
+        target_controls.at(j) = 1.;
+
+        cost_table[i*dimension + j] = costs(edge,
+                                            source_controls,
+                                            target_controls);
+
+        assert(cost_table[i*dimension + j] >= 0.);
+
+        target_controls.at(j) = 0.;
+      }
+
+      source_controls.at(i) = 0.;
+    }
+  }
+
+  return cost_tables;
+}
@@ -4,6 +4,8 @@
 #include "controls.hh"
 #include "util.hh"
 #include "graph/graph.hh"
+#include "graph/edge_map.hh"
+#include "graph/edge_set.hh"
 #include "graph/vertex_map.hh"
 
 class CostFunction
@@ -39,4 +41,59 @@ public:
 
 };
 
+/**
+ * Returns for each Edge the costs of all pairs of
+ * (integral) controls of its source and target, stored
+ * as a row-major matrix.
+ **/
+EdgeMap<std::vector<double>> tabulate_costs(const Graph& graph,
+                                            const CostFunction& costs,
+                                            idx dimension);
+
+/**
+ * Evaluates a CostFunction defined on the Edge%s of another Graph,
+ * e.g. of a Graph whose vertices have been reordered. Edges
+ * which have been reversed are evaluated with swapped controls.
+ **/
+class MappedCosts : public CostFunction
+{
+private:
+  const CostFunction& costs;
+  const EdgeMap<Edge>& original_edges;
+  const EdgeSet& reversed_edges;
+public:
+  MappedCosts(const CostFunction& costs,
+              const EdgeMap<Edge>& original_edges,
+              const EdgeSet& reversed_edges)
+    : costs(costs),
+      original_edges(original_edges),
+      reversed_edges(reversed_edges)
+  {}
+
+  double operator()(const Edge& edge,
+                    double previous_control,
+                    double current_control) const override
+  {
+    if(reversed_edges.contains(edge))
+    {
+      return costs(original_edges(edge), current_control, previous_control);
+    }
+
+    return costs(original_edges(edge), previous_control, current_control);
+  }
+
+  double operator()(const Edge& edge,
+                    const Controls& previous_controls,
+                    const Controls& current_controls) const override
+  {
+    if(reversed_edges.contains(edge))
+    {
+      return costs(original_edges(edge), current_controls, previous_controls);
+    }
+
+    return costs(original_edges(edge), previous_controls, current_controls);
+  }
+
+};
+
 #endif /* COST_FUNCTION_HH */
@@ -0,0 +1,345 @@
+#include "dag_callback.hh"
+
+#include <algorithm>
+#include <memory>
+
+#include "cmp.hh"
+#include "log.hh"
+
+DAGCallback::DAGCallback(DAGProgram& program)
+  : program(program),
+    sum_layers(compute_sum_layers(program.graph,
+                                  program.fractional_controls,
+                                  program.upper_bound)),
+    heuristics(false),
+    lazy_constraints(false),
+    record_trajectory(false),
+    num_rounded(0),
+    num_suggested(0),
+    num_lazy_constraints(0),
+    num_cuts(0)
+{
+  for(const Vertex& vertex : program.graph.get_vertices())
+  {
+    for(const GRBVar& variable : program.variables(vertex))
+    {
+      control_variables.push_back(variable);
+    }
+  }
+}
+
+void DAGCallback::update_sum_layers()
+{
+  sum_layers = compute_sum_layers(program.graph,
+                                  program.fractional_controls,
+                                  program.upper_bound);
+}
+
+void DAGCallback::suggest_solution(const VertexMap<Controls>& controls)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+
+  suggested_solution = controls;
+}
+
+std::optional<VertexMap<Controls>>
+DAGCallback::round_relaxation(const double* values) const
+{
+  const Graph& graph = program.graph;
+  const idx dimension = program.dimension;
+
+  VertexMap<Controls> rounded_controls(graph, Controls(dimension, 0.));
+
+  std::vector<double> relaxed_control_sums(dimension, 0.);
+  std::vector<idx> control_sums(dimension, 0);
+
+  idx index = 0;
+
+  for(const Vertex& vertex : graph.get_vertices())
+  {
+    const double* vertex_values = values + index * dimension;
+
+    idx next_control = dimension;
+    double next_val = -inf;
+
+    for(idx i = 0; i < dimension; ++i)
+    {
+      relaxed_control_sums[i] += vertex_values[i];
+    }
+
+    for(idx i = 0; i < dimension; ++i)
+    {
+      ++control_sums[i];
+
+      const bool feasible = sum_layers[index].encode(control_sums).has_value();
+
+      --control_sums[i];
+
+      if(!feasible)
+      {
+        continue;
+      }
+
+      const double val = relaxed_control_sums[i] - ((double) control_sums[i]);
+
+      if(val > next_val)
+      {
+        next_val = val;
+        next_control = i;
+      }
+    }
+
+    // the greedy rounding ran into a dead end
+    if(next_control == dimension)
+    {
+      return {};
+    }
+
+    rounded_controls(vertex).at(next_control) = 1.;
+    ++control_sums[next_control];
+
+    ++index;
+  }
+
+  return rounded_controls;
+}
+
+void DAGCallback::inject_solution(const VertexMap<Controls>& controls)
+{
+  std::vector<GRBVar> variables;
+  std::vector<double> values;
+
+  program.get_solution(controls, variables, values);
+
+  setSolution(variables.data(), values.data(), variables.size());
+
+  useSolution();
+}
+
+idx DAGCallback::add_violated_constraints(const double* values,
+                                          double tolerance,
+                                          bool lazy)
+{
+  const Graph& graph = program.graph;
+  const idx dimension = program.dimension;
+  const double upper_bound = program.upper_bound;
+
+  const idx num_vertices = graph.get_vertices().size();
+
+  idx num_added = 0;
+
+  auto add_constraint = [&](idx i, idx last_index, char sense, double rhs)
+    {
+      GRBLinExpr sum;
+
+      for(idx index = 0; index <= last_index; ++index)
+      {
+        sum += control_variables[index * dimension + i];
+      }
+
+      if(lazy)
+      {
+        addLazy(sum, sense, rhs);
+      }
+      else
+      {
+        addCut(sum, sense, rhs);
+      }
+
+      ++num_added;
+    };
+
+  for(idx i = 0; i < dimension; ++i)
+  {
+    double control_sum = 0.;
+    double fractional_control_sum = 0.;
+
+    bool lower_violated = false;
+    bool upper_violated = false;
+
+    for(idx index = 0; index < num_vertices; ++index)
+    {
+      const Vertex vertex = graph.get_vertices()[index];
+
+      control_sum += values[index * dimension + i];
+      fractional_control_sum += program.fractional_controls(vertex).at(i);
+
+      if(!lower_violated &&
+         control_sum < fractional_control_sum - upper_bound - tolerance)
+      {
+        add_constraint(i, index, GRB_GREATER_EQUAL, fractional_control_sum - upper_bound);
+        lower_violated = true;
+      }
+
+      if(!upper_violated &&
+         control_sum > fractional_control_sum + upper_bound + tolerance)
+      {
+        add_constraint(i, index, GRB_LESS_EQUAL, fractional_control_sum + upper_bound);
+        upper_violated = true;
+      }
+
+      if(lower_violated && upper_violated)
+      {
+        break;
+      }
+    }
+  }
+
+  return num_added;
+}
+
+void DAGCallback::run_heuristics(bool solved)
+{
+  const Graph& graph = program.graph;
+  const CostFunction& costs = program.costs;
+
+  const double incumbent = getDoubleInfo(GRB_CB_MIPNODE_OBJBST);
+
+  std::optional<VertexMap<Controls>> suggested;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    suggested.swap(suggested_solution);
+  }
+
+  if(suggested)
+  {
+    const double suggested_cost = costs.evaluate(graph, *suggested);
+
+    if(cmp::lt(suggested_cost, incumbent))
+    {
+      Log(info) << "Injecting suggested solution with costs "
+                << suggested_cost;
+
+      inject_solution(*suggested);
+      ++num_suggested;
+    }
+  }
+
+  if(!solved)
+  {
+    return;
+  }
+
+  std::unique_ptr<double[]> values(getNodeRel(control_variables.data(),
+                                               control_variables.size()));
+
+  auto rounded_controls = round_relaxation(values.get());
+
+  if(!rounded_controls)
+  {
+    return;
+  }
+
+  const double rounded_cost = costs.evaluate(graph, *rounded_controls);
+
+  if(cmp::lt(rounded_cost, incumbent))
+  {
+    Log(debug) << "Injecting rounded solution with costs "
+               << rounded_cost;
+
+    inject_solution(*rounded_controls);
+    ++num_rounded;
+  }
+}
+
+void DAGCallback::add_point(const TrajectoryPoint& point)
+{
+  if(!trajectory.empty() &&
+     trajectory.back().incumbent == point.incumbent &&
+     trajectory.back().bound == point.bound)
+  {
+    return;
+  }
+
+  trajectory.push_back(point);
+}
+
+void DAGCallback::record_progress()
+{
+  auto normalize = [](double value) -> double
+    {
+      if(value >= GRB_INFINITY)
+      {
+        return inf;
+      }
+      else if(value <= -GRB_INFINITY)
+      {
+        return -inf;
+      }
+
+      return value;
+    };
+
+  if(where == GRB_CB_MIP)
+  {
+    add_point(TrajectoryPoint{getDoubleInfo(GRB_CB_RUNTIME),
+                              normalize(getDoubleInfo(GRB_CB_MIP_OBJBST)),
+                              normalize(getDoubleInfo(GRB_CB_MIP_OBJBND)),
+                              getDoubleInfo(GRB_CB_MIP_NODCNT)});
+  }
+  // solutions may still be rejected by lazy constraints
+  else if(where == GRB_CB_MIPSOL && !lazy_constraints)
+  {
+    const double incumbent = std::min(getDoubleInfo(GRB_CB_MIPSOL_OBJ),
+                                      getDoubleInfo(GRB_CB_MIPSOL_OBJBST));
+
+    add_point(TrajectoryPoint{getDoubleInfo(GRB_CB_RUNTIME),
+                              normalize(incumbent),
+                              normalize(getDoubleInfo(GRB_CB_MIPSOL_OBJBND)),
+                              getDoubleInfo(GRB_CB_MIPSOL_NODCNT)});
+  }
+}
+
+void DAGCallback::callback()
+{
+  try
+  {
+    if(program.terminated)
+    {
+      abort();
+      return;
+    }
+
+    if(record_trajectory)
+    {
+      record_progress();
+    }
+
+    if(where == GRB_CB_MIPSOL && lazy_constraints)
+    {
+      std::unique_ptr<double[]> values(getSolution(control_variables.data(),
+                                                   control_variables.size()));
+
+      num_lazy_constraints += add_violated_constraints(values.get(),
+                                                       cmp::eps,
+                                                       true);
+    }
+    else if(where == GRB_CB_MIPNODE)
+    {
+      const bool solved = (getIntInfo(GRB_CB_MIPNODE_STATUS) == GRB_OPTIMAL);
+
+      if(lazy_constraints && solved)
+      {
+        const double cut_tolerance = 1e-4;
+
+        std::unique_ptr<double[]> values(getNodeRel(control_variables.data(),
+                                                     control_variables.size()));
+
+        num_cuts += add_violated_constraints(values.get(),
+                                             cut_tolerance,
+                                             false);
+      }
+
+      if(heuristics)
+      {
+        run_heuristics(solved);
+      }
+    }
+  }
+  catch(GRBException& exc)
+  {
+    Log(error) << "Caught Gurobi exception in callback: "
+               << exc.getMessage();
+  }
+}
@@ -0,0 +1,151 @@
+#ifndef DAG_CALLBACK_HH
+#define DAG_CALLBACK_HH
+
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include <gurobi_c++.h>
+
+#include "control_sums.hh"
+#include "controls.hh"
+#include "dag_program.hh"
+#include "trajectory.hh"
+
+/**
+ * A callback of the DAGProgram, serving two purposes:
+ *
+ * - Injecting heuristic solutions during the branch-and-bound. At
+ *   each node whose relaxation was solved to optimality, the controls
+ *   of the relaxation are rounded in a sum-up-rounding fashion,
+ *   restricted to the controls which keep the control sums within the
+ *   approximation bounds. Additionally, solutions suggested from
+ *   other threads (e.g., by a concurrently running SCARPProgram)
+ *   are injected at the next node.
+ *
+ * - Separating the approximation constraints of the lazy
+ *   formulation: violated constraints are added as lazy constraints
+ *   for new incumbents and as cuts for node relaxations.
+ *
+ * - Recording the Trajectory of the incumbent and the bound.
+ **/
+class DAGCallback : public GRBCallback
+{
+private:
+  DAGProgram& program;
+
+  std::vector<SumLayer> sum_layers;
+
+  std::vector<GRBVar> control_variables;
+
+  std::mutex mutex;
+  std::optional<VertexMap<Controls>> suggested_solution;
+
+  bool heuristics;
+  bool lazy_constraints;
+  bool record_trajectory;
+
+  Trajectory trajectory;
+
+  idx num_rounded;
+  idx num_suggested;
+  idx num_lazy_constraints;
+  idx num_cuts;
+
+  std::optional<VertexMap<Controls>> round_relaxation(const double* values) const;
+
+  void inject_solution(const VertexMap<Controls>& controls);
+
+  /**
+   * Adds the first violated lower / upper approximation constraint
+   * of each control (either as lazy constraint or as cut), returns
+   * the number of added constraints.
+   **/
+  idx add_violated_constraints(const double* values,
+                               double tolerance,
+                               bool lazy);
+
+  /**
+   * Injects suggested solutions and, if the node relaxation
+   * was solved, its rounded controls.
+   **/
+  void run_heuristics(bool solved);
+
+  void record_progress();
+
+protected:
+  void callback() override;
+
+public:
+  DAGCallback(DAGProgram& program);
+
+  /**
+   * Recomputes the bounds of the control sums after the
+   * fractional controls of the DAGProgram have changed.
+   **/
+  void update_sum_layers();
+
+  void set_heuristics(bool heuristics)
+  {
+    this->heuristics = heuristics;
+  }
+
+  void set_lazy_constraints(bool lazy_constraints)
+  {
+    this->lazy_constraints = lazy_constraints;
+  }
+
+  void set_record_trajectory(bool record_trajectory)
+  {
+    this->record_trajectory = record_trajectory;
+  }
+
+  bool get_record_trajectory() const
+  {
+    return record_trajectory;
+  }
+
+  void clear_trajectory()
+  {
+    trajectory.clear();
+  }
+
+  /**
+   * Appends the given point to the Trajectory if either
+   * the incumbent or the bound changed.
+   **/
+  void add_point(const TrajectoryPoint& point);
+
+  const Trajectory& get_trajectory() const
+  {
+    return trajectory;
+  }
+
+  /**
+   * Suggests a solution to be injected at the next node.
+   * May be called from any thread.
+   **/
+  void suggest_solution(const VertexMap<Controls>& controls);
+
+  idx get_num_rounded() const
+  {
+    return num_rounded;
+  }
+
+  idx get_num_suggested() const
+  {
+    return num_suggested;
+  }
+
+  idx get_num_lazy_constraints() const
+  {
+    return num_lazy_constraints;
+  }
+
+  idx get_num_cuts() const
+  {
+    return num_cuts;
+  }
+};
+
+#endif /* DAG_CALLBACK_HH */
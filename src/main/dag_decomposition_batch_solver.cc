@@ -0,0 +1,213 @@
+#include <fstream>
+#include <filesystem>
+#include <stdexcept>
+#include <thread>
+
+#include <boost/program_options.hpp>
+namespace po = boost::program_options;
+
+#include "control_reader.hh"
+#include "control_writer.hh"
+
+#include "cost_function.hh"
+#include "dag_program.hh"
+#include "decomposition.hh"
+#include "environment_pool.hh"
+#include "grid.hh"
+#include "log.hh"
+#include "timer.hh"
+
+#include "exact_scarp/exact_program.hh"
+#include "scarp/scarp_program.hh"
+#include "sur/sur.hh"
+
+int main(int argc, char *argv[])
+{
+  log_init();
+
+  po::options_description desc("Allowed options");
+
+  std::vector<std::string> input_names;
+  std::string output_name;
+
+  bool sur = false;
+  bool exact = false;
+  bool mip = false;
+  bool monolithic = false;
+
+  idx tile_size = 16;
+  idx overlap = 2;
+  idx threads = std::max(std::thread::hardware_concurrency(), 1u);
+
+  desc.add_options()
+    ("help", "produce help message")
+    ("sur", po::bool_switch(&sur)->default_value(false), "solve tiles using SUR")
+    ("exact", po::bool_switch(&exact)->default_value(false), "solve tiles using the exact labeling")
+    ("mip", po::bool_switch(&mip)->default_value(false), "solve tiles using the MIP")
+    ("monolithic", po::bool_switch(&monolithic)->default_value(false), "additionally solve the entire instance to report the speedup")
+    ("tile_size", po::value<idx>(&tile_size)->default_value(tile_size), "size of the tiles in grid cells")
+    ("overlap", po::value<idx>(&overlap)->default_value(overlap), "overlap of the tiles in grid cells")
+    ("threads", po::value<idx>(&threads)->default_value(threads), "number of tiles solved in parallel")
+    ("input", po::value<std::vector<std::string>>(&input_names)->required(), "input file")
+    ("output", po::value<std::string>(&output_name)->required(), "output file");
+
+  po::variables_map vm;
+
+  po::positional_options_description positional_options;
+  positional_options.add("input", -1);
+
+  po::store(po::command_line_parser(argc, argv)
+            .options(desc)
+            .positional(positional_options)
+            .run(),
+            vm);
+
+  if(vm.count("help"))
+  {
+    std::cerr << "Usage: "
+              << argv[0]
+              << " [options] <input> <ouput>"
+              << std::endl;
+
+    std::cerr << desc << std::endl;
+
+    return 1;
+  }
+
+  po::notify(vm);
+
+  TileSolver tile_solver = [](const Graph& graph,
+                              const CostFunction& costs,
+                              const VertexMap<Controls>& fractional_controls)
+    {
+      return SCARPProgram(graph, costs, fractional_controls).solve();
+    };
+
+  if(sur)
+  {
+    tile_solver = [](const Graph& graph,
+                     const CostFunction& costs,
+                     const VertexMap<Controls>& fractional_controls)
+      {
+        return compute_sur_controls(graph, fractional_controls, costs);
+      };
+  }
+  else if(exact)
+  {
+    tile_solver = [](const Graph& graph,
+                     const CostFunction& costs,
+                     const VertexMap<Controls>& fractional_controls)
+      {
+        return ExactProgram(graph, costs, fractional_controls).solve();
+      };
+  }
+  else if(mip)
+  {
+    // tiles are solved in parallel rather than each one using all cores
+    EnvironmentPool::get_instance().set_threads((threads > 1) ? 1 : 0);
+
+    tile_solver = [](const Graph& graph,
+                     const CostFunction& costs,
+                     const VertexMap<Controls>& fractional_controls)
+      {
+        try
+        {
+          return DAGProgram(graph,
+                            fractional_controls,
+                            costs,
+                            Formulation::CUMULATIVE).solve();
+        }
+        catch(GRBException& exc)
+        {
+          throw std::runtime_error(exc.getMessage());
+        }
+      };
+  }
+
+  std::ofstream output(output_name);
+
+  output << "Name;Objective;Distance;UpperBound;RunningTime;Tiles;Repaired";
+
+  if(monolithic)
+  {
+    output << ";MonolithicObjective;MonolithicTime;Speedup";
+  }
+
+  output << std::endl;
+
+  for(const std::string& input_name : input_names)
+  {
+    std::ifstream input(input_name);
+    auto result = read_file(input);
+
+    const idx grid_length = compute_grid_length(result.graph,
+                                                result.coordinates);
+
+    const double scale_factor = 1. / ((double) grid_length);
+
+    auto costs = VariationalCosts(scale_factor);
+
+    const Vertex source = *result.graph.get_vertices().begin();
+    const idx dimension = result.fractional_controls(source).size();
+
+    const double upper_bound = max_control_deviation(dimension);
+
+    Timer timer;
+
+    DecompositionSolver solver(result.graph,
+                               costs,
+                               result.fractional_controls,
+                               result.coordinates,
+                               tile_solver,
+                               tile_size,
+                               overlap,
+                               threads);
+
+    auto decomposed_controls = solver.solve();
+
+    const double elapsed = timer.elapsed();
+
+    const double distance = control_distance(result.graph,
+                                             result.fractional_controls,
+                                             decomposed_controls);
+
+    const double control_cost = costs.evaluate(result.graph, decomposed_controls);
+
+    Log(info) << "Distance between controls: "
+              << distance
+              << ", upper bound: "
+              << upper_bound
+              << ", control costs: "
+              << control_cost;
+
+    std::string stem = std::filesystem::path(input_name).stem();
+
+    output << stem << ";"
+           << control_cost << ";"
+           << distance << ";"
+           << upper_bound << ";"
+           << elapsed << ";"
+           << solver.get_num_tiles() << ";"
+           << solver.get_num_repaired();
+
+    if(monolithic)
+    {
+      Timer monolithic_timer;
+
+      auto monolithic_controls = tile_solver(result.graph,
+                                             costs,
+                                             result.fractional_controls);
+
+      const double monolithic_elapsed = monolithic_timer.elapsed();
+
+      output << ";"
+             << costs.evaluate(result.graph, monolithic_controls) << ";"
+             << monolithic_elapsed << ";"
+             << (monolithic_elapsed / elapsed);
+    }
+
+    output << std::endl;
+  }
+
+  return 0;
+}
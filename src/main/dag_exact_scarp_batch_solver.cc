@@ -1,5 +1,6 @@
 #include <fstream>
 #include <filesystem>
+#include <limits>
 
 #include <boost/program_options.hpp>
 namespace po = boost::program_options;
@@ -11,6 +12,9 @@ namespace po = boost::program_options;
 #include "timer.hh"
 
 #include "exact_scarp/exact_program.hh"
+#include "exact_scarp/reordered_program.hh"
+#include "exact_scarp/table_program.hh"
+#include "sorted_scarp/sorted_program.hh"
 
 int main(int argc, char *argv[])
 {
@@ -22,10 +26,24 @@ int main(int argc, char *argv[])
   std::string output_name;
 
   bool vanishing_constraints = false;
+  bool reorder = false;
+  bool tables = false;
+  bool sorted = false;
+
+  idx history_length = 0;
+  idx label_limit = 0;
+
+  double time_limit = inf;
 
   desc.add_options()
     ("help", "produce help message")
     ("vanishing_constraints", po::bool_switch(&vanishing_constraints)->default_value(false), "enable vanishing constraints")
+    ("reorder", po::bool_switch(&reorder)->default_value(false), "reorder vertices to reduce prefix lengths")
+    ("tables", po::bool_switch(&tables)->default_value(false), "use transition tables (grids swept row by row only)")
+    ("sorted", po::bool_switch(&sorted)->default_value(false), "deduplicate labels by sorting")
+    ("history", po::value<idx>(&history_length)->default_value(history_length), "number of controls stored in labels (0: exact)")
+    ("time_limit", po::value<double>(&time_limit)->default_value(time_limit), "time limit in seconds (labeling only)")
+    ("label_limit", po::value<idx>(&label_limit)->default_value(label_limit), "maximum number of labels (labeling only, 0: unlimited)")
     ("input", po::value<std::vector<std::string>>(&input_names)->required(), "input file")
     ("output", po::value<std::string>(&output_name)->required(), "output file");
 
@@ -54,9 +72,25 @@ int main(int argc, char *argv[])
 
   po::notify(vm);
 
+  if(tables && history_length > 0)
+  {
+    std::cerr << "The transition tables do not support a bounded history" << std::endl;
+    return 1;
+  }
+
+  if(history_length == 0)
+  {
+    history_length = ExactProgram::unbounded_history;
+  }
+
+  if(label_limit == 0)
+  {
+    label_limit = std::numeric_limits<idx>::max();
+  }
+
   std::ofstream output(output_name);
 
-  output << "Name;Objective;Distance;UpperBound;RunningTime" << std::endl;
+  output << "Name;Objective;Distance;UpperBound;RunningTime;Status" << std::endl;
 
   for(const std::string& input_name : input_names)
   {
@@ -70,13 +104,78 @@ int main(int argc, char *argv[])
 
     auto costs = VariationalCosts(scale_factor);
 
-    ExactProgram program(result.graph,
-                         costs,
-                         result.fractional_controls);
+    bool optimal = false;
+    bool feasible = true;
+
+    auto set_budgets = [&](ExactProgram& program)
+      {
+        program.set_time_limit(time_limit);
+        program.set_label_limit(label_limit);
+      };
+
+    auto solve = [&]() -> VertexMap<Controls>
+      {
+        if(tables)
+        {
+          TableProgram program(result.graph,
+                               costs,
+                               result.fractional_controls,
+                               result.coordinates);
+
+          optimal = true;
+
+          return program.solve();
+        }
+
+        if(sorted)
+        {
+          SortedProgram program(result.graph,
+                                costs,
+                                result.fractional_controls,
+                                false,
+                                history_length);
+
+          optimal = (history_length == ExactProgram::unbounded_history);
+
+          return program.solve();
+        }
+
+        if(reorder)
+        {
+          ReorderedProgram program(result.graph,
+                                   costs,
+                                   result.fractional_controls,
+                                   false,
+                                   history_length);
+
+          set_budgets(program.get_program());
+
+          auto controls = program.solve();
+
+          optimal = program.is_optimal();
+          feasible = program.is_feasible();
+
+          return controls;
+        }
+
+        ExactProgram program(result.graph,
+                             costs,
+                             result.fractional_controls,
+                             false,
+                             history_length);
+
+        set_budgets(program);
+
+        auto controls = program.solve();
+
+        optimal = program.is_optimal();
+
+        return controls;
+      };
 
     Timer timer;
 
-    auto scarp_controls = program.solve();
+    auto scarp_controls = solve();
 
     const double elapsed = timer.elapsed();
 
@@ -111,7 +210,8 @@ int main(int argc, char *argv[])
            << control_cost << ";"
            << distance << ";"
            << upper_bound << ";"
-           << elapsed
+           << elapsed << ";"
+           << (optimal ? "Optimal" : (feasible ? "Feasible" : "Infeasible"))
            << std::endl;
   }
 
@@ -1,5 +1,7 @@
 #include <fstream>
 #include <filesystem>
+#include <memory>
+#include <optional>
 
 #include <boost/program_options.hpp>
 namespace po = boost::program_options;
@@ -11,6 +13,7 @@ namespace po = boost::program_options;
 #include "grid.hh"
 #include "log.hh"
 #include "timer.hh"
+#include "trajectory.hh"
 
 #include "dag_program.hh"
 #include "scarp/scarp_program.hh"
@@ -23,14 +26,31 @@ int main(int argc, char *argv[])
 
   std::vector<std::string> input_names;
   std::string output_name;
+  std::string trajectory_dir;
 
   bool scarp_heuristic = false;
   bool vanishing_constraints = false;
+  bool cumulative = false;
+  bool lazy = false;
+  bool named = false;
+  bool heuristic_callback = false;
+  bool sequence = false;
+
+  idx threads = 0;
+  double time_limit = inf;
 
   desc.add_options()
     ("help", "produce help message")
     ("scarp_heuristic", po::bool_switch(&scarp_heuristic)->default_value(false), "use SCARP has heuristic")
     ("vanishing_constraints", po::bool_switch(&vanishing_constraints)->default_value(false), "enable vanishing constraints")
+    ("heuristic_callback", po::bool_switch(&heuristic_callback)->default_value(false), "inject rounded and concurrent SCARP solutions")
+    ("cumulative", po::bool_switch(&cumulative)->default_value(false), "use cumulative approximation constraints")
+    ("lazy", po::bool_switch(&lazy)->default_value(false), "separate approximation constraints lazily")
+    ("named", po::bool_switch(&named)->default_value(false), "name variables and constraints (for debugging)")
+    ("sequence", po::bool_switch(&sequence)->default_value(false), "treat the inputs as a sequence on the same grid, warm-starting from the previous solution")
+    ("threads", po::value<idx>(&threads)->default_value(threads), "number of threads (0: automatic)")
+    ("time_limit", po::value<double>(&time_limit)->default_value(time_limit), "time limit in seconds")
+    ("trajectory_dir", po::value<std::string>(&trajectory_dir), "directory to write trajectories to")
     ("input", po::value<std::vector<std::string>>(&input_names)->required(), "input file")
     ("output", po::value<std::string>(&output_name)->required(), "output file");
 
@@ -59,21 +79,75 @@ int main(int argc, char *argv[])
 
   po::notify(vm);
 
+  if(cumulative && lazy)
+  {
+    std::cerr << "The cumulative and the lazy formulation cannot be combined" << std::endl;
+    return 1;
+  }
+
+  Formulation formulation = Formulation::DENSE;
+
+  if(cumulative)
+  {
+    formulation = Formulation::CUMULATIVE;
+  }
+  else if(lazy)
+  {
+    formulation = Formulation::LAZY;
+  }
+
+  EnvironmentPool& environment_pool = EnvironmentPool::get_instance();
+
+  environment_pool.set_threads(threads);
+  environment_pool.set_time_limit(time_limit);
+
   std::ofstream output(output_name);
 
-  output << "Name;Objective;Distance;UpperBound;RunningTime" << std::endl;
+  output << "Name;Objective;Distance;UpperBound;RunningTime;TimeToFeasible;TimeToGap1";
+
+  if(sequence)
+  {
+    output << ";ReadTime";
+  }
+
+  output << std::endl;
+
+  SequenceReader reader;
+
+  // retained between the steps of a sequence
+  std::unique_ptr<VariationalCosts> cost_function;
+  std::unique_ptr<DAGProgram> mip_program;
+  std::unique_ptr<SCARPProgram> scarp_program;
 
   for(const std::string& input_name : input_names)
   {
+    if(!sequence)
+    {
+      mip_program.reset();
+      scarp_program.reset();
+      reader.reset();
+    }
+
+    Timer read_timer;
+
     std::ifstream input(input_name);
-    auto result = read_file(input);
+    const ReadResult& result = reader.read(input);
+
+    const double read_time = read_timer.elapsed();
+
+    const bool warm_start = sequence && mip_program;
 
-    const idx grid_length = compute_grid_length(result.graph,
-                                                result.coordinates);
+    if(!warm_start)
+    {
+      const idx grid_length = compute_grid_length(result.graph,
+                                                  result.coordinates);
+
+      const double scale_factor = 1. / ((double) grid_length);
 
-    const double scale_factor = 1. / ((double) grid_length);
+      cost_function = std::make_unique<VariationalCosts>(scale_factor);
+    }
 
-    auto costs = VariationalCosts(scale_factor);
+    const VariationalCosts& costs = *cost_function;
 
     const Vertex source = *result.graph.get_vertices().begin();
     const idx dimension = result.fractional_controls(source).size();
@@ -82,17 +156,43 @@ int main(int argc, char *argv[])
 
     Timer timer;
 
-    DAGProgram program(result.graph,
-                       result.fractional_controls,
-                       costs);
+    if(warm_start)
+    {
+      // the previous solution is kept as a start if it remains feasible
+      mip_program->update_fractional_controls(result.fractional_controls);
+    }
+    else
+    {
+      mip_program = std::make_unique<DAGProgram>(result.graph,
+                                                 result.fractional_controls,
+                                                 costs,
+                                                 formulation,
+                                                 named);
+
+      mip_program->enable_trajectory();
+
+      if(heuristic_callback)
+      {
+        mip_program->enable_heuristic_callback();
+      }
+    }
+
+    DAGProgram& program = *mip_program;
 
     if(scarp_heuristic)
     {
-      SCARPProgram scarp_program(result.graph,
-                                 costs,
-                                 result.fractional_controls);
-
-      auto scarp_controls = scarp_program.solve();
+      if(warm_start)
+      {
+        scarp_program->update_fractional_controls(result.fractional_controls);
+      }
+      else
+      {
+        scarp_program = std::make_unique<SCARPProgram>(result.graph,
+                                                       costs,
+                                                       result.fractional_controls);
+      }
+
+      auto scarp_controls = scarp_program->solve();
 
       const double control_cost = costs.evaluate(result.graph, scarp_controls);
 
@@ -102,15 +202,32 @@ int main(int argc, char *argv[])
       program.set_initial_solution(scarp_controls);
     }
 
-    auto mip_controls = program.solve();
+    std::optional<VertexMap<Controls>> mip_controls;
+
+    try
+    {
+      mip_controls = program.solve();
+    }
+    catch(const std::runtime_error& exc)
+    {
+      // e.g., no solution within the time limit
+      Log(error) << "Failed to solve "
+                 << input_name
+                 << ": "
+                 << exc.what();
+    }
 
     const double elapsed = timer.elapsed();
 
-    const double distance = control_distance(result.graph,
-                                             result.fractional_controls,
-                                             mip_controls);
+    const double distance = mip_controls ?
+      control_distance(result.graph,
+                       result.fractional_controls,
+                       *mip_controls) :
+      inf;
 
-    const double control_cost = costs.evaluate(result.graph, mip_controls);
+    const double control_cost = mip_controls ?
+      costs.evaluate(result.graph, *mip_controls) :
+      inf;
 
     Log(info) << "Distance between controls: "
               << distance
@@ -128,12 +245,30 @@ int main(int argc, char *argv[])
 
     std::string stem = std::filesystem::path(input_name).stem();
 
+    const Trajectory trajectory = program.get_trajectory();
+
+    if(!trajectory_dir.empty())
+    {
+      std::ofstream trajectory_output(std::filesystem::path(trajectory_dir) / (stem + ".csv"));
+
+      write_trajectory(trajectory, trajectory_output);
+    }
+
     output << stem << ";"
            << control_cost << ";"
            << distance << ";"
            << upper_bound << ";"
-           << elapsed
-           << std::endl;
+           << elapsed << ";"
+           << time_to_feasible(trajectory).value_or(inf) << ";"
+           << time_to_gap(trajectory, 0.01).value_or(inf);
+
+    if(sequence)
+    {
+      output << ";"
+             << read_time;
+    }
+
+    output << std::endl;
   }
 
   return 0;
@@ -1,4 +1,5 @@
 #include <fstream>
+#include <stdexcept>
 
 #include "control_reader.hh"
 #include "control_writer.hh"
@@ -43,6 +44,11 @@ int main(int argc, char *argv[])
     Log(error) << "Caught Gurobi exception: " << exc.getMessage();
     return 1;
   }
+  catch(const std::runtime_error& exc)
+  {
+    Log(error) << "Failed to solve: " << exc.what();
+    return 1;
+  }
 
 
   return 0;
@@ -0,0 +1,152 @@
+#include <fstream>
+#include <filesystem>
+
+#include <boost/program_options.hpp>
+namespace po = boost::program_options;
+
+#include "control_reader.hh"
+#include "control_writer.hh"
+
+#include "cost_function.hh"
+#include "grid.hh"
+#include "log.hh"
+#include "multilevel.hh"
+#include "timer.hh"
+
+#include "scarp/scarp_program.hh"
+
+int main(int argc, char *argv[])
+{
+  log_init();
+
+  po::options_description desc("Allowed options");
+
+  std::vector<std::string> input_names;
+  std::string output_name;
+
+  bool compare = false;
+
+  idx num_levels = 0;
+  idx corridor_width = 3;
+
+  desc.add_options()
+    ("help", "produce help message")
+    ("levels", po::value<idx>(&num_levels)->default_value(num_levels), "number of coarsening levels (0: solve SCARP directly)")
+    ("corridor", po::value<idx>(&corridor_width)->default_value(corridor_width), "initial width of the corridors around the prolonged solutions")
+    ("compare", po::bool_switch(&compare)->default_value(false), "additionally solve the finest level using SCARP to report the speedup")
+    ("input", po::value<std::vector<std::string>>(&input_names)->required(), "input file")
+    ("output", po::value<std::string>(&output_name)->required(), "output file");
+
+  po::variables_map vm;
+
+  po::positional_options_description positional_options;
+  positional_options.add("input", -1);
+
+  po::store(po::command_line_parser(argc, argv)
+            .options(desc)
+            .positional(positional_options)
+            .run(),
+            vm);
+
+  if(vm.count("help"))
+  {
+    std::cerr << "Usage: "
+              << argv[0]
+              << " [options] <input> <ouput>"
+              << std::endl;
+
+    std::cerr << desc << std::endl;
+
+    return 1;
+  }
+
+  po::notify(vm);
+
+  std::ofstream output(output_name);
+
+  output << "Name;Objective;Distance;UpperBound;RunningTime;Labels;Widenings";
+
+  if(compare)
+  {
+    output << ";SCARPObjective;SCARPTime;SCARPLabels;Speedup";
+  }
+
+  output << std::endl;
+
+  for(const std::string& input_name : input_names)
+  {
+    std::ifstream input(input_name);
+    auto result = read_file(input);
+
+    const idx grid_length = compute_grid_length(result.graph,
+                                                result.coordinates);
+
+    const double scale_factor = 1. / ((double) grid_length);
+
+    auto costs = VariationalCosts(scale_factor);
+
+    const Vertex source = *result.graph.get_vertices().begin();
+    const idx dimension = result.fractional_controls(source).size();
+
+    const double upper_bound = max_control_deviation(dimension);
+
+    Timer timer;
+
+    MultilevelSCARP solver(result.graph,
+                           costs,
+                           result.fractional_controls,
+                           result.coordinates,
+                           num_levels,
+                           corridor_width);
+
+    auto multilevel_controls = solver.solve();
+
+    const double elapsed = timer.elapsed();
+
+    const double distance = control_distance(result.graph,
+                                             result.fractional_controls,
+                                             multilevel_controls);
+
+    const double control_cost = costs.evaluate(result.graph, multilevel_controls);
+
+    Log(info) << "Distance between controls: "
+              << distance
+              << ", upper bound: "
+              << upper_bound
+              << ", control costs: "
+              << control_cost;
+
+    std::string stem = std::filesystem::path(input_name).stem();
+
+    output << stem << ";"
+           << control_cost << ";"
+           << distance << ";"
+           << upper_bound << ";"
+           << elapsed << ";"
+           << solver.get_num_labels() << ";"
+           << solver.get_num_widenings();
+
+    if(compare)
+    {
+      Timer scarp_timer;
+
+      SCARPProgram program(result.graph,
+                           costs,
+                           result.fractional_controls);
+
+      auto scarp_controls = program.solve();
+
+      const double scarp_elapsed = scarp_timer.elapsed();
+
+      output << ";"
+             << costs.evaluate(result.graph, scarp_controls) << ";"
+             << scarp_elapsed << ";"
+             << program.get_num_labels() << ";"
+             << (scarp_elapsed / elapsed);
+    }
+
+    output << std::endl;
+  }
+
+  return 0;
+}
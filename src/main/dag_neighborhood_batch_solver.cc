@@ -0,0 +1,153 @@
+#include <fstream>
+#include <filesystem>
+
+#include <boost/program_options.hpp>
+namespace po = boost::program_options;
+
+#include "control_reader.hh"
+#include "control_writer.hh"
+
+#include "cost_function.hh"
+#include "environment_pool.hh"
+#include "grid.hh"
+#include "log.hh"
+#include "neighborhood_search.hh"
+#include "timer.hh"
+
+#include "scarp/scarp_program.hh"
+#include "sur/sur.hh"
+
+int main(int argc, char *argv[])
+{
+  log_init();
+
+  po::options_description desc("Allowed options");
+
+  std::vector<std::string> input_names;
+  std::string output_name;
+
+  bool sur = false;
+  bool skip_rins = false;
+
+  idx window_size = 256;
+  idx threads = 1;
+  idx max_rounds = 10;
+  double time_limit = inf;
+
+  desc.add_options()
+    ("help", "produce help message")
+    ("sur", po::bool_switch(&sur)->default_value(false), "start from the SUR instead of the SCARP solution")
+    ("skip_rins", po::bool_switch(&skip_rins)->default_value(false), "skip the RINS neighborhood")
+    ("window", po::value<idx>(&window_size)->default_value(window_size), "number of vertices per window")
+    ("threads", po::value<idx>(&threads)->default_value(threads), "number of windows solved in parallel")
+    ("rounds", po::value<idx>(&max_rounds)->default_value(max_rounds), "maximum number of rounds over all windows")
+    ("time_limit", po::value<double>(&time_limit)->default_value(time_limit), "time limit in seconds per neighborhood")
+    ("input", po::value<std::vector<std::string>>(&input_names)->required(), "input file")
+    ("output", po::value<std::string>(&output_name)->required(), "output file");
+
+  po::variables_map vm;
+
+  po::positional_options_description positional_options;
+  positional_options.add("input", -1);
+
+  po::store(po::command_line_parser(argc, argv)
+            .options(desc)
+            .positional(positional_options)
+            .run(),
+            vm);
+
+  if(vm.count("help"))
+  {
+    std::cerr << "Usage: "
+              << argv[0]
+              << " [options] <input> <ouput>"
+              << std::endl;
+
+    std::cerr << desc << std::endl;
+
+    return 1;
+  }
+
+  po::notify(vm);
+
+  EnvironmentPool& environment_pool = EnvironmentPool::get_instance();
+
+  // windows are solved in parallel rather than each one using all cores
+  environment_pool.set_threads((threads > 1) ? 1 : 0);
+  environment_pool.set_time_limit(time_limit);
+
+  std::ofstream output(output_name);
+
+  output << "Name;Objective;Distance;UpperBound;RunningTime;InitialObjective" << std::endl;
+
+  for(const std::string& input_name : input_names)
+  {
+    std::ifstream input(input_name);
+    auto result = read_file(input);
+
+    const idx grid_length = compute_grid_length(result.graph,
+                                                result.coordinates);
+
+    const double scale_factor = 1. / ((double) grid_length);
+
+    auto costs = VariationalCosts(scale_factor);
+
+    const Vertex source = *result.graph.get_vertices().begin();
+    const idx dimension = result.fractional_controls(source).size();
+
+    const double upper_bound = max_control_deviation(dimension);
+
+    Timer timer;
+
+    VertexMap<Controls> initial_controls = sur ?
+      compute_sur_controls(result.graph,
+                           result.fractional_controls,
+                           costs) :
+      SCARPProgram(result.graph,
+                   costs,
+                   result.fractional_controls).solve();
+
+    const double initial_cost = costs.evaluate(result.graph, initial_controls);
+
+    Log(info) << "Costs of initial solution: "
+              << initial_cost;
+
+    NeighborhoodSearch search(result.graph,
+                              result.fractional_controls,
+                              costs,
+                              window_size,
+                              threads,
+                              max_rounds);
+
+    auto improved_controls = skip_rins ?
+      search.improve_windows(initial_controls) :
+      search.improve(initial_controls);
+
+    const double elapsed = timer.elapsed();
+
+    const double distance = control_distance(result.graph,
+                                             result.fractional_controls,
+                                             improved_controls);
+
+    const double control_cost = costs.evaluate(result.graph, improved_controls);
+
+    Log(info) << "Distance between controls: "
+              << distance
+              << ", upper bound: "
+              << upper_bound
+              << ", control costs: "
+              << control_cost;
+
+    std::string stem = std::filesystem::path(input_name).stem();
+
+    output << stem << ";"
+           << control_cost << ";"
+           << distance << ";"
+           << upper_bound << ";"
+           << elapsed << ";"
+           << initial_cost
+           << std::endl;
+  }
+
+  return 0;
+}
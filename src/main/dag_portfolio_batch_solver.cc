@@ -0,0 +1,119 @@
+#include <fstream>
+#include <filesystem>
+
+#include <boost/program_options.hpp>
+namespace po = boost::program_options;
+
+#include "control_reader.hh"
+#include "control_writer.hh"
+
+#include "cost_function.hh"
+#include "environment_pool.hh"
+#include "grid.hh"
+#include "log.hh"
+#include "portfolio.hh"
+#include "timer.hh"
+
+int main(int argc, char *argv[])
+{
+  log_init();
+
+  po::options_description desc("Allowed options");
+
+  std::vector<std::string> input_names;
+  std::string output_name;
+
+  idx threads = 0;
+  double time_limit = 60.;
+
+  desc.add_options()
+    ("help", "produce help message")
+    ("threads", po::value<idx>(&threads)->default_value(threads), "number of MIP threads (0: automatic)")
+    ("time_limit", po::value<double>(&time_limit)->default_value(time_limit), "time limit in seconds")
+    ("input", po::value<std::vector<std::string>>(&input_names)->required(), "input file")
+    ("output", po::value<std::string>(&output_name)->required(), "output file");
+
+  po::variables_map vm;
+
+  po::positional_options_description positional_options;
+  positional_options.add("input", -1);
+
+  po::store(po::command_line_parser(argc, argv)
+            .options(desc)
+            .positional(positional_options)
+            .run(),
+            vm);
+
+  if(vm.count("help"))
+  {
+    std::cerr << "Usage: "
+              << argv[0]
+              << " [options] <input> <ouput>"
+              << std::endl;
+
+    std::cerr << desc << std::endl;
+
+    return 1;
+  }
+
+  po::notify(vm);
+
+  EnvironmentPool::get_instance().set_threads(threads);
+
+  std::ofstream output(output_name);
+
+  output << "Name;Objective;Distance;UpperBound;RunningTime;Solver;Status" << std::endl;
+
+  for(const std::string& input_name : input_names)
+  {
+    std::ifstream input(input_name);
+    auto result = read_file(input);
+
+    const idx grid_length = compute_grid_length(result.graph,
+                                                result.coordinates);
+
+    const double scale_factor = 1. / ((double) grid_length);
+
+    auto costs = VariationalCosts(scale_factor);
+
+    const Vertex source = *result.graph.get_vertices().begin();
+    const idx dimension = result.fractional_controls(source).size();
+
+    const double upper_bound = max_control_deviation(dimension);
+
+    Timer timer;
+
+    Portfolio portfolio(result.graph,
+                        result.fractional_controls,
+                        costs,
+                        time_limit);
+
+    const PortfolioResult portfolio_result = portfolio.solve();
+
+    const double elapsed = timer.elapsed();
+
+    const double distance = control_distance(result.graph,
+                                             result.fractional_controls,
+                                             portfolio_result.controls);
+
+    Log(info) << "Distance between controls: "
+              << distance
+              << ", upper bound: "
+              << upper_bound
+              << ", control costs: "
+              << portfolio_result.costs;
+
+    std::string stem = std::filesystem::path(input_name).stem();
+
+    output << stem << ";"
+           << portfolio_result.costs << ";"
+           << distance << ";"
+           << upper_bound << ";"
+           << elapsed << ";"
+           << portfolio_result.solver << ";"
+           << (portfolio_result.optimal ? "Optimal" : "Feasible")
+           << std::endl;
+  }
+
+  return 0;
+}
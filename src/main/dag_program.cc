@@ -1,51 +1,283 @@
 #include "dag_program.hh"
 
+#include <atomic>
+#include <cmath>
+#include <memory>
 #include <sstream>
+#include <stdexcept>
+#include <thread>
 
 #include "cmp.hh"
 #include "controls.hh"
+#include "dag_callback.hh"
 #include "log.hh"
+#include "timer.hh"
+
+#include "scarp/scarp_program.hh"
+
+namespace
+{
+  std::string no_name()
+  {
+    return std::string();
+  }
+
+  /*
+   * Collects variables which are then added in a single call,
+   * names are only generated on request.
+   */
+  class ColumnBuffer
+  {
+  private:
+    const bool named;
+
+    std::vector<double> lower;
+    std::vector<double> upper;
+    std::vector<double> objective;
+    std::vector<char> types;
+    std::vector<std::string> names;
+
+  public:
+    ColumnBuffer(bool named)
+      : named(named)
+    {}
+
+    template <class Name>
+    void add(double lb, double ub, double obj, char type, Name name)
+    {
+      lower.push_back(lb);
+      upper.push_back(ub);
+      objective.push_back(obj);
+      types.push_back(type);
+
+      if(named)
+      {
+        names.push_back(name());
+      }
+    }
+
+    std::vector<GRBVar> commit(GRBModel& model)
+    {
+      const idx size = lower.size();
+
+      std::unique_ptr<GRBVar[]> variables(model.addVars(lower.data(),
+                                                        upper.data(),
+                                                        objective.data(),
+                                                        types.data(),
+                                                        named ? names.data() : nullptr,
+                                                        size));
+
+      return std::vector<GRBVar>(variables.get(), variables.get() + size);
+    }
+  };
+
+  /*
+   * Collects constraints which are then added in chunks of
+   * a fixed number of rows (bounding the memory used by the
+   * buffered expressions), names are only generated on request.
+   */
+  class RowBuffer
+  {
+  private:
+    static const idx chunk_size = 4096;
+
+    GRBModel& model;
+    const bool named;
+
+    std::vector<GRBLinExpr> expressions;
+    std::vector<char> senses;
+    std::vector<double> values;
+    std::vector<std::string> names;
+
+    std::vector<GRBConstr> constraints;
+
+    void flush()
+    {
+      const idx size = expressions.size();
+
+      if(size == 0)
+      {
+        return;
+      }
+
+      std::unique_ptr<GRBConstr[]> added(model.addConstrs(expressions.data(),
+                                                          senses.data(),
+                                                          values.data(),
+                                                          named ? names.data() : nullptr,
+                                                          size));
+
+      constraints.insert(std::end(constraints), added.get(), added.get() + size);
+
+      expressions.clear();
+      senses.clear();
+      values.clear();
+      names.clear();
+    }
+
+  public:
+    RowBuffer(GRBModel& model, bool named)
+      : model(model),
+        named(named)
+    {}
+
+    template <class Name = decltype(&no_name)>
+    void add(const GRBLinExpr& expression, char sense, double value, Name name = no_name)
+    {
+      expressions.push_back(expression);
+      senses.push_back(sense);
+      values.push_back(value);
+
+      if(named)
+      {
+        names.push_back(name());
+      }
+
+      if(expressions.size() >= chunk_size)
+      {
+        flush();
+      }
+    }
+
+    std::vector<GRBConstr> commit()
+    {
+      flush();
+
+      return std::move(constraints);
+    }
+  };
+
+  /*
+   * Interrupts and joins a concurrent thread when leaving
+   * the scope, even if an exception is thrown.
+   */
+  class ThreadGuard
+  {
+  private:
+    std::thread& thread;
+    std::atomic<bool>& interrupt;
+
+  public:
+    ThreadGuard(std::thread& thread, std::atomic<bool>& interrupt)
+      : thread(thread),
+        interrupt(interrupt)
+    {}
+
+    ~ThreadGuard()
+    {
+      interrupt = true;
+
+      if(thread.joinable())
+      {
+        thread.join();
+      }
+    }
+  };
+}
+
+DAGProgram::DAGProgram(const Graph& graph,
+                       const VertexMap<Controls>& fractional_controls,
+                       const CostFunction& costs,
+                       Formulation formulation,
+                       bool named)
+  : DAGProgram(graph,
+               fractional_controls,
+               costs,
+               EnvironmentPool::get_instance().acquire(),
+               formulation,
+               named)
+{
+}
 
 DAGProgram::DAGProgram(const Graph& graph,
                        const VertexMap<Controls>& fractional_controls,
-                       const CostFunction& costs)
-  : model(env),
+                       const CostFunction& costs,
+                       GRBEnv& env,
+                       Formulation formulation,
+                       bool named)
+  : DAGProgram(graph,
+               fractional_controls,
+               costs,
+               EnvironmentLease(env),
+               formulation,
+               named)
+{
+}
+
+DAGProgram::DAGProgram(const Graph& graph,
+                       const VertexMap<Controls>& fractional_controls,
+                       const CostFunction& costs,
+                       EnvironmentLease&& lease,
+                       Formulation formulation,
+                       bool named)
+  : lease(std::move(lease)),
+    model(this->lease.get()),
     graph(graph),
     fractional_controls(fractional_controls),
     costs(costs),
     variables(graph, {}),
+    formulation(formulation),
+    named(named),
     source(*graph.get_vertices().begin()),
     dimension(fractional_controls(source).size()),
     upper_bound(max_control_deviation(dimension)),
-    cost_variables(graph, std::vector<CostVariable>{})
+    cost_variables(graph, std::vector<CostVariable>{}),
+    concurrent_scarp(false),
+    optimal(false),
+    terminated(false)
 {
   assert(controls_are_convex(graph, fractional_controls));
 
+  Timer timer;
+
   create_variables();
   add_vertex_constraints();
   add_approximation_constraints();
   add_objective();
+
+  if(formulation == Formulation::LAZY)
+  {
+    model.set(GRB_IntParam_LazyConstraints, 1);
+    model.set(GRB_IntParam_PreCrush, 1);
+
+    get_callback().set_lazy_constraints(true);
+  }
+
+  model.update();
+
+  Log(info) << "Built model with "
+            << model.get(GRB_IntAttr_NumVars) << " variables, "
+            << model.get(GRB_IntAttr_NumConstrs) << " constraints and "
+            << model.get(GRB_IntAttr_NumNZs) << " nonzeros in "
+            << timer.elapsed() << "s";
 }
 
 void DAGProgram::create_variables()
 {
   Log(debug) << "Creating variables";
 
+  ColumnBuffer columns(named);
+
   for(const Vertex& vertex : graph.get_vertices())
   {
     for(idx i = 0; i < dimension; ++i)
     {
-      std::ostringstream namebuf;
-      namebuf << "x_" << vertex.get_index() << "_" << i;
+      columns.add(0., 1., 0., GRB_BINARY, [&]()
+        {
+          std::ostringstream namebuf;
+          namebuf << "x_" << vertex.get_index() << "_" << i;
+          return namebuf.str();
+        });
+    }
+  }
 
-      GRBVar var = model.addVar(0.,
-                                1.,
-                                0.,
-                                GRB_BINARY,
-                                namebuf.str());
+  std::vector<GRBVar> control_variables = columns.commit(model);
 
-      variables(vertex).push_back(var);
-    }
+  auto it = std::begin(control_variables);
+
+  for(const Vertex& vertex : graph.get_vertices())
+  {
+    variables(vertex).assign(it, it + dimension);
+    it += dimension;
   }
 }
 
@@ -53,116 +285,195 @@ void DAGProgram::add_vertex_constraints()
 {
   Log(debug) << "Adding vertex constraints";
 
+  RowBuffer rows(model, named);
+
+  const std::vector<double> ones(dimension, 1.);
+
   for(const Vertex& vertex : graph.get_vertices())
   {
     GRBLinExpr sum;
 
-    for(const auto& variable : variables(vertex))
-    {
-      sum += variable;
-    }
+    sum.addTerms(ones.data(), variables(vertex).data(), dimension);
 
-    std::ostringstream namebuf;
+    rows.add(sum, GRB_EQUAL, 1., [&]()
+      {
+        std::ostringstream namebuf;
+        namebuf << "one_" << vertex.get_index();
+        return namebuf.str();
+      });
+  }
 
-    namebuf << "one_" << vertex.get_index();
+  rows.commit();
+}
 
-    model.addConstr(sum == 1, namebuf.str());
+void DAGProgram::add_approximation_constraints()
+{
+  if(formulation == Formulation::CUMULATIVE)
+  {
+    add_cumulative_approximation_constraints();
+  }
+  else if(formulation == Formulation::LAZY)
+  {
+    Log(debug) << "Deferring approximation constraints to the callback";
+  }
+  else
+  {
+    add_dense_approximation_constraints();
   }
 }
 
-void DAGProgram::add_approximation_constraints()
+void DAGProgram::add_dense_approximation_constraints()
 {
   Log(debug) << "Adding approximation constraints";
 
+  const idx num_vertices = graph.get_vertices().size();
+
+  RowBuffer rows(model, named);
+
+  const std::vector<double> ones(num_vertices, 1.);
+
+  std::vector<GRBVar> control_variables;
+
+  control_variables.reserve(num_vertices);
+
   for(idx i = 0; i < dimension; ++i)
   {
+    control_variables.clear();
+
+    double fractional_control_sum = 0.;
+
     for(const Vertex& current : graph.get_vertices())
     {
+      fractional_control_sum += fractional_controls(current).at(i);
+
+      control_variables.push_back(variables(current).at(i));
+
       GRBLinExpr sum;
 
-      double fractional_control_sum = 0.;
+      sum.addTerms(ones.data(),
+                   control_variables.data(),
+                   control_variables.size());
 
-      for(const Vertex& previous : graph.get_vertices())
-      {
-        if(current < previous)
+      rows.add(sum, GRB_GREATER_EQUAL, fractional_control_sum - upper_bound, [&]()
         {
-          break;
-        }
-
-        fractional_control_sum += fractional_controls(previous).at(i);
+          std::ostringstream namebuf;
+          namebuf << "approx_lower" << current.get_index() << "_" << i;
+          return namebuf.str();
+        });
 
-        sum += variables(previous).at(i);
-      }
+      rows.add(sum, GRB_LESS_EQUAL, fractional_control_sum + upper_bound, [&]()
+        {
+          std::ostringstream namebuf;
+          namebuf << "approx_upper" << current.get_index() << "_" << i;
+          return namebuf.str();
+        });
+    }
+  }
 
-      {
-        std::ostringstream namebuf;
+  approximation_constraints = rows.commit();
+}
 
-        namebuf << "approx_lower" << current.get_index() << "_" << i;
+void DAGProgram::add_cumulative_approximation_constraints()
+{
+  Log(debug) << "Adding cumulative approximation constraints";
 
-        model.addConstr((fractional_control_sum - upper_bound) <= sum, namebuf.str());
-      }
+  const idx num_vertices = graph.get_vertices().size();
 
-      {
-        std::ostringstream namebuf;
+  ColumnBuffer columns(named);
 
-        namebuf << "approx_upper" << current.get_index() << "_" << i;
+  for(idx i = 0; i < dimension; ++i)
+  {
+    double fractional_control_sum = 0.;
 
-        model.addConstr(sum <= (upper_bound + fractional_control_sum), namebuf.str());
-      }
+    for(const Vertex& current : graph.get_vertices())
+    {
+      fractional_control_sum += fractional_controls(current).at(i);
+
+      columns.add(fractional_control_sum - upper_bound,
+                  fractional_control_sum + upper_bound,
+                  0.,
+                  GRB_CONTINUOUS,
+                  [&]()
+                  {
+                    std::ostringstream namebuf;
+                    namebuf << "s_" << current.get_index() << "_" << i;
+                    return namebuf.str();
+                  });
     }
   }
-}
 
-void DAGProgram::add_objective()
-{
-  Log(debug) << "Adding objective variables";
+  sum_variables = columns.commit(model);
 
-  auto add_objective_term = [&](const GRBVar& first,
-                                const GRBVar& second,
-                                bool first_flipped,
-                                bool second_flipped,
-                                double cost) -> GRBVar
+  RowBuffer rows(model, named);
+
+  const double coefficients[] = {1., -1., -1.};
+
+  for(idx i = 0; i < dimension; ++i)
+  {
+    for(const Vertex& current : graph.get_vertices())
     {
-      GRBLinExpr first_expr, second_expr;
+      const idx index = current.get_index();
 
-      if(first_flipped)
-      {
-        first_expr = 1. - first;
-      }
-      else
-      {
-        first_expr = first;
-      }
+      const GRBVar* sum = sum_variables.data() + i * num_vertices + index;
 
-      if(second_flipped)
-      {
-        second_expr = 1. - second;
-      }
-      else
-      {
-        second_expr = second;
-      }
+      // s_v - x_v - s_{v-1} = 0
+      const GRBVar terms[] = {sum[0],
+                              variables(current).at(i),
+                              (index > 0) ? sum[-1] : sum[0]};
+
+      GRBLinExpr expr;
 
-      GRBVar var = model.addVar(0.,
-                                1.,
-                                cost,
-                                GRB_CONTINUOUS,
-                                "");
+      expr.addTerms(coefficients, terms, (index > 0) ? 3 : 2);
 
-      model.addConstr(first_expr + second_expr <= 1 + var);
+      rows.add(expr, GRB_EQUAL, 0., [&]()
+        {
+          std::ostringstream namebuf;
+          namebuf << "cumulative_" << index << "_" << i;
+          return namebuf.str();
+        });
+    }
+  }
 
-      return var;
-    };
+  rows.commit();
+}
+
+void DAGProgram::add_objective()
+{
+  Log(debug) << "Adding objective variables";
+
+  ColumnBuffer columns(named);
 
   for(const Edge& edge : graph.get_edges())
   {
-    Vertex source = edge.get_source();
-    Vertex target = edge.get_target();
+    // Symmetric costs of the form c|x_s - x_t| (e.g., VariationalCosts)
+    // only require a single variable per control
+    const double switch_cost = costs(edge, 0., 1.);
+
+    const bool absolute = cmp::pos(switch_cost) &&
+      cmp::eq(costs(edge, 1., 0.), switch_cost) &&
+      cmp::zero(costs(edge, 0., 0.)) &&
+      cmp::zero(costs(edge, 1., 1.));
 
     for(idx i = 0; i < dimension; ++i)
     {
-      GRBVar source_var = variables(source).at(i);
-      GRBVar target_var = variables(target).at(i);
+      if(absolute)
+      {
+        columns.add(0., 1., switch_cost, GRB_CONTINUOUS, [&]()
+          {
+            std::ostringstream namebuf;
+            namebuf << "abs_" << edge.get_index() << "_" << i;
+            return namebuf.str();
+          });
+
+        cost_variables(edge).push_back(CostVariable{
+            i,
+            false,
+            false,
+            true,
+            GRBVar()});
+
+        continue;
+      }
 
       for(auto source_val : {0, 1})
       {
@@ -179,32 +490,214 @@ void DAGProgram::add_objective()
 
           assert(edge_cost >= 0.);
 
-          bool source_inv = source_val == 0;
-          bool target_inv = target_val == 0;
-
-          GRBVar var = add_objective_term(source_var,
-                                          target_var,
-                                          source_inv,
-                                          target_inv,
-                                          edge_cost);
+          columns.add(0., 1., edge_cost, GRB_CONTINUOUS, [&]()
+            {
+              std::ostringstream namebuf;
+              namebuf << "cost_" << edge.get_index() << "_" << i
+                      << "_" << source_val << target_val;
+              return namebuf.str();
+            });
 
           cost_variables(edge).push_back(CostVariable{
               i,
-              source_inv,
-              target_inv,
-              var});
-
+              source_val == 0,
+              target_val == 0,
+              false,
+              GRBVar()});
         }
       }
     }
   }
+
+  const std::vector<GRBVar> objective_variables = columns.commit(model);
+
+  auto it = std::begin(objective_variables);
+
+  RowBuffer rows(model, named);
+
+  for(const Edge& edge : graph.get_edges())
+  {
+    Vertex source = edge.get_source();
+    Vertex target = edge.get_target();
+
+    for(auto& cost_variable : cost_variables(edge))
+    {
+      const idx i = cost_variable.i;
+
+      cost_variable.var = *(it++);
+
+      const GRBVar terms[] = {variables(source).at(i),
+                              variables(target).at(i),
+                              cost_variable.var};
+
+      if(cost_variable.absolute)
+      {
+        // x_s - x_t <= d, x_t - x_s <= d
+        const double first_coefficients[] = {1., -1., -1.};
+        const double second_coefficients[] = {-1., 1., -1.};
+
+        GRBLinExpr first_expr, second_expr;
+
+        first_expr.addTerms(first_coefficients, terms, 3);
+        second_expr.addTerms(second_coefficients, terms, 3);
+
+        rows.add(first_expr, GRB_LESS_EQUAL, 0.);
+        rows.add(second_expr, GRB_LESS_EQUAL, 0.);
+
+        continue;
+      }
+
+      // (1 - x_s or x_s) + (1 - x_t or x_t) <= 1 + y
+      const double coefficients[] = {cost_variable.source_inv ? -1. : 1.,
+                                     cost_variable.target_inv ? -1. : 1.,
+                                     -1.};
+
+      const double rhs = 1. - cost_variable.source_inv - cost_variable.target_inv;
+
+      GRBLinExpr expr;
+
+      expr.addTerms(coefficients, terms, 3);
+
+      rows.add(expr, GRB_LESS_EQUAL, rhs);
+    }
+  }
+
+  rows.commit();
+}
+
+DAGProgram::~DAGProgram()
+{
+}
+
+DAGCallback& DAGProgram::get_callback()
+{
+  if(!callback)
+  {
+    callback = std::make_unique<DAGCallback>(*this);
+    model.setCallback(callback.get());
+  }
+
+  return *callback;
+}
+
+void DAGProgram::enable_heuristic_callback(bool concurrent_scarp)
+{
+  get_callback().set_heuristics(true);
+
+  this->concurrent_scarp = concurrent_scarp;
+}
+
+void DAGProgram::enable_trajectory()
+{
+  get_callback().set_record_trajectory(true);
+}
+
+void DAGProgram::set_time_limit(double time_limit)
+{
+  model.set(GRB_DoubleParam_TimeLimit, time_limit == inf ? GRB_INFINITY : time_limit);
+}
+
+void DAGProgram::suggest_solution(const VertexMap<Controls>& controls)
+{
+  // the callback must not be created concurrently to solve()
+  assert(callback);
+
+  callback->suggest_solution(controls);
+}
+
+void DAGProgram::terminate()
+{
+  // the callback additionally aborts a solve() which
+  // is just about to start
+  terminated = true;
+
+  model.terminate();
+}
+
+Trajectory DAGProgram::get_trajectory() const
+{
+  if(!callback)
+  {
+    return Trajectory();
+  }
+
+  return callback->get_trajectory();
 }
 
 VertexMap<Controls> DAGProgram::solve()
 {
   Log(info) << "Solving model";
 
-  model.optimize();
+  {
+    std::thread scarp_thread;
+    std::atomic<bool> scarp_interrupt(false);
+
+    ThreadGuard scarp_guard(scarp_thread, scarp_interrupt);
+
+    if(callback && concurrent_scarp)
+    {
+      scarp_thread = std::thread([&]()
+        {
+          SCARPProgram scarp_program(graph,
+                                     costs,
+                                     fractional_controls);
+
+          scarp_program.set_interrupt(&scarp_interrupt);
+
+          try
+          {
+            callback->suggest_solution(scarp_program.solve());
+          }
+          catch(const std::runtime_error&)
+          {
+            // interrupted once the optimization has finished
+          }
+        });
+    }
+
+    if(callback)
+    {
+      callback->clear_trajectory();
+    }
+
+    model.optimize();
+  }
+
+  terminated = false;
+
+  optimal = (model.get(GRB_IntAttr_Status) == GRB_OPTIMAL);
+
+  if(callback && callback->get_record_trajectory())
+  {
+    const bool feasible = model.get(GRB_IntAttr_SolCount) > 0;
+
+    callback->add_point(TrajectoryPoint{model.get(GRB_DoubleAttr_Runtime),
+                                        feasible ? model.get(GRB_DoubleAttr_ObjVal) : inf,
+                                        model.get(GRB_DoubleAttr_ObjBound),
+                                        model.get(GRB_DoubleAttr_NodeCount)});
+  }
+
+  if(callback)
+  {
+    Log(info) << "Injected "
+              << callback->get_num_rounded()
+              << " rounded and "
+              << callback->get_num_suggested()
+              << " suggested solutions, added "
+              << callback->get_num_lazy_constraints()
+              << " lazy constraints and "
+              << callback->get_num_cuts()
+              << " cuts";
+  }
+
+  // e.g., if the time limit was reached or the solve was terminated
+  if(model.get(GRB_IntAttr_SolCount) == 0)
+  {
+    Log(info) << "Found no solution, status: "
+              << model.get(GRB_IntAttr_Status);
+
+    throw std::runtime_error("No solution found");
+  }
 
   VertexMap<Controls> rounded_controls(graph, Controls(dimension, 0.));
 
@@ -233,17 +726,166 @@ VertexMap<Controls> DAGProgram::solve()
 
   assert(cmp::eq(control_cost, obj_val, eps));
 
+  last_solution = rounded_controls;
+
   return rounded_controls;
 }
 
-void DAGProgram::set_initial_solution(const VertexMap<Controls>& initial_solution)
+double DAGProgram::solve_relaxation()
+{
+  VertexMap<Controls> relaxed_controls(graph, Controls(dimension, 0.));
+
+  return solve_relaxation(relaxed_controls);
+}
+
+double DAGProgram::solve_relaxation(VertexMap<Controls>& relaxed_controls)
+{
+  Log(info) << "Solving LP relaxation";
+
+  GRBModel relaxation = model.relax();
+
+  relaxation.optimize();
+
+  if(relaxation.get(GRB_IntAttr_Status) != GRB_OPTIMAL)
+  {
+    throw std::runtime_error("Failed to solve LP relaxation");
+  }
+
+  // the relaxed model retains the order of the variables
+  for(const Vertex& vertex : graph.get_vertices())
+  {
+    relaxed_controls(vertex).resize(dimension);
+
+    for(idx i = 0; i < dimension; ++i)
+    {
+      GRBVar relaxed_var = relaxation.getVar(variables(vertex).at(i).index());
+
+      relaxed_controls(vertex).at(i) = relaxed_var.get(GRB_DoubleAttr_X);
+    }
+  }
+
+  return relaxation.get(GRB_DoubleAttr_ObjVal);
+}
+
+void DAGProgram::fix_controls(const VertexMap<Controls>& controls,
+                              const std::vector<Vertex>& vertices)
+{
+  std::vector<GRBVar> fixed_variables;
+  std::vector<double> values;
+
+  for(const Vertex& vertex : vertices)
+  {
+    for(idx i = 0; i < dimension; ++i)
+    {
+      fixed_variables.push_back(variables(vertex).at(i));
+      values.push_back(controls(vertex).at(i));
+    }
+  }
+
+  model.set(GRB_DoubleAttr_LB, fixed_variables.data(), values.data(), fixed_variables.size());
+  model.set(GRB_DoubleAttr_UB, fixed_variables.data(), values.data(), fixed_variables.size());
+}
+
+void DAGProgram::release_controls()
 {
+  std::vector<GRBVar> control_variables;
+
+  for(const Vertex& vertex : graph.get_vertices())
+  {
+    control_variables.insert(std::end(control_variables),
+                             std::begin(variables(vertex)),
+                             std::end(variables(vertex)));
+  }
+
+  std::vector<double> lower_bounds(control_variables.size(), 0.);
+  std::vector<double> upper_bounds(control_variables.size(), 1.);
+
+  model.set(GRB_DoubleAttr_LB, control_variables.data(), lower_bounds.data(), control_variables.size());
+  model.set(GRB_DoubleAttr_UB, control_variables.data(), upper_bounds.data(), control_variables.size());
+}
+
+void DAGProgram::update_fractional_controls(const VertexMap<Controls>& fractional_controls)
+{
+  assert(controls_are_convex(graph, fractional_controls));
+  assert(fractional_controls(source).size() == dimension);
+
+  this->fractional_controls = fractional_controls;
+
+  const idx num_vertices = graph.get_vertices().size();
+
+  std::vector<double> lower_bounds;
+  std::vector<double> upper_bounds;
+
+  for(idx i = 0; i < dimension; ++i)
+  {
+    double fractional_control_sum = 0.;
+
+    for(const Vertex& vertex : graph.get_vertices())
+    {
+      fractional_control_sum += fractional_controls(vertex).at(i);
+
+      lower_bounds.push_back(fractional_control_sum - upper_bound);
+      upper_bounds.push_back(fractional_control_sum + upper_bound);
+    }
+  }
+
+  if(formulation == Formulation::CUMULATIVE)
+  {
+    model.set(GRB_DoubleAttr_LB, sum_variables.data(), lower_bounds.data(), sum_variables.size());
+    model.set(GRB_DoubleAttr_UB, sum_variables.data(), upper_bounds.data(), sum_variables.size());
+  }
+  else if(formulation == Formulation::DENSE)
+  {
+    // lower and upper constraints alternate
+    std::vector<double> values;
+
+    values.reserve(approximation_constraints.size());
+
+    for(idx k = 0; k < dimension * num_vertices; ++k)
+    {
+      values.push_back(lower_bounds[k]);
+      values.push_back(upper_bounds[k]);
+    }
+
+    model.set(GRB_DoubleAttr_RHS,
+              approximation_constraints.data(),
+              values.data(),
+              approximation_constraints.size());
+  }
+
+  if(callback)
+  {
+    callback->update_sum_layers();
+  }
+
+  if(last_solution)
+  {
+    const double distance = control_distance(graph,
+                                             fractional_controls,
+                                             *last_solution);
+
+    if(cmp::le(distance, upper_bound))
+    {
+      Log(info) << "Keeping previous solution as a start";
+
+      set_initial_solution(*last_solution);
+    }
+  }
+}
+
+void DAGProgram::get_solution(const VertexMap<Controls>& controls,
+                              std::vector<GRBVar>& solution_variables,
+                              std::vector<double>& solution_values) const
+{
+  solution_variables.clear();
+  solution_values.clear();
+
   for(const Vertex& vertex : graph.get_vertices())
   {
     for(idx i = 0; i < dimension; ++i)
     {
-      variables(vertex).at(i).set(GRB_DoubleAttr_Start,
-                                  initial_solution(vertex).at(i));
+      solution_variables.push_back(variables(vertex).at(i));
+      solution_values.push_back(controls(vertex).at(i));
     }
   }
 
@@ -252,12 +894,20 @@ void DAGProgram::set_initial_solution(const VertexMap<Controls>& initial_solutio
     Vertex source = edge.get_source();
     Vertex target = edge.get_target();
 
-    for(auto& cost_variable : cost_variables(edge))
+    for(const auto& cost_variable : cost_variables(edge))
     {
       const idx i = cost_variable.i;
 
-      const double source_val = initial_solution(source).at(i);
-      const double target_val = initial_solution(target).at(i);
+      const double source_val = controls(source).at(i);
+      const double target_val = controls(target).at(i);
+
+      solution_variables.push_back(cost_variable.var);
+
+      if(cost_variable.absolute)
+      {
+        solution_values.push_back(std::abs(source_val - target_val));
+        continue;
+      }
 
       const bool source_inv = (source_val == 0.);
       const bool target_inv = (target_val == 0.);
@@ -265,12 +915,49 @@ void DAGProgram::set_initial_solution(const VertexMap<Controls>& initial_solutio
       if(source_inv == cost_variable.source_inv &&
          target_inv == cost_variable.target_inv)
       {
-        cost_variable.var.set(GRB_DoubleAttr_Start, 1.);
+        solution_values.push_back(1.);
       }
       else
       {
-        cost_variable.var.set(GRB_DoubleAttr_Start, 0.);
+        solution_values.push_back(0.);
       }
     }
   }
 }
+
+void DAGProgram::set_initial_solution(const VertexMap<Controls>& initial_solution)
+{
+  std::vector<GRBVar> solution_variables;
+  std::vector<double> solution_values;
+
+  get_solution(initial_solution,
+               solution_variables,
+               solution_values);
+
+  model.set(GRB_DoubleAttr_Start,
+            solution_variables.data(),
+            solution_values.data(),
+            solution_variables.size());
+}
+
+double compute_lower_bound(const Graph& graph,
+                           const VertexMap<Controls>& fractional_controls,
+                           const CostFunction& costs)
+{
+  Timer timer;
+
+  DAGProgram program(graph,
+                     fractional_controls,
+                     costs,
+                     Formulation::CUMULATIVE);
+
+  const double lower_bound = program.solve_relaxation();
+
+  Log(info) << "Computed lower bound of "
+            << lower_bound
+            << " in "
+            << timer.elapsed()
+            << "s";
+
+  return lower_bound;
+}
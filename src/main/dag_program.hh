@@ -1,30 +1,60 @@
 #ifndef DAG_PROGRAM_HH
 #define DAG_PROGRAM_HH
 
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <vector>
+
 #include <gurobi_c++.h>
 
 #include "controls.hh"
 #include "cost_function.hh"
+#include "environment_pool.hh"
+#include "trajectory.hh"
 #include "graph/graph.hh"
 #include "graph/edge_map.hh"
 #include "graph/vertex_map.hh"
 
+/**
+ * @enum Formulation The formulations of the approximation constraints
+ **/
+enum class Formulation
+{
+  /** Each constraint sums up the controls of all previous vertices **/
+  DENSE,
+  /** Auxiliary variables store the sums of the controls up to each vertex **/
+  CUMULATIVE,
+  /** Violated constraints are separated in a callback **/
+  LAZY
+};
+
+class DAGCallback;
+
 class DAGProgram
 {
 private:
-  GRBEnv env;
+  EnvironmentLease lease;
   GRBModel model;
 
   const Graph& graph;
-  const VertexMap<Controls>& fractional_controls;
+  // copied, since the controls may be updated later on
+  VertexMap<Controls> fractional_controls;
   const CostFunction& costs;
 
   VertexMap<std::vector<GRBVar>> variables;
 
+  const Formulation formulation;
+
+  // whether variables and constraints are named (for debugging)
+  const bool named;
+
   void create_variables();
   void add_vertex_constraints();
   void add_objective();
   void add_approximation_constraints();
+  void add_dense_approximation_constraints();
+  void add_cumulative_approximation_constraints();
 
   const Vertex source;
   const idx dimension;
@@ -35,20 +65,164 @@ private:
     idx i;
     bool source_inv;
     bool target_inv;
+    // models |x_s - x_t| rather than a single assignment
+    bool absolute;
     GRBVar var;
   };
 
   EdgeMap<std::vector<CostVariable>> cost_variables;
 
+  // the lower / upper constraints of the dense formulation
+  std::vector<GRBConstr> approximation_constraints;
+
+  // the prefix sums of the cumulative formulation
+  std::vector<GRBVar> sum_variables;
+
+  std::optional<VertexMap<Controls>> last_solution;
+
+  std::unique_ptr<DAGCallback> callback;
+  bool concurrent_scarp;
+
+  bool optimal;
+  std::atomic<bool> terminated;
+
+  DAGCallback& get_callback();
+
+  /**
+   * Collects the variables of the controls and the objective
+   * together with their values for the given integral controls.
+   **/
+  void get_solution(const VertexMap<Controls>& controls,
+                    std::vector<GRBVar>& solution_variables,
+                    std::vector<double>& solution_values) const;
+
+  friend class DAGCallback;
+
 public:
+  /**
+   * Constructs a new DAGProgram whose model is created in an
+   * environment borrowed from the process-wide EnvironmentPool.
+   **/
+  DAGProgram(const Graph& graph,
+             const VertexMap<Controls>& fractional_controls,
+             const CostFunction& costs,
+             Formulation formulation = Formulation::DENSE,
+             bool named = false);
+
   DAGProgram(const Graph& graph,
              const VertexMap<Controls>& fractional_controls,
-             const CostFunction& costs);
+             const CostFunction& costs,
+             GRBEnv& env,
+             Formulation formulation = Formulation::DENSE,
+             bool named = false);
 
+  DAGProgram(const Graph& graph,
+             const VertexMap<Controls>& fractional_controls,
+             const CostFunction& costs,
+             EnvironmentLease&& lease,
+             Formulation formulation = Formulation::DENSE,
+             bool named = false);
+
+  ~DAGProgram();
+
+  /**
+   * Enables a callback which injects heuristic solutions obtained
+   * by rounding node relaxations. If requested, the SCARPProgram is
+   * solved in a concurrent thread and its solution injected as soon
+   * as it becomes available. The thread is interrupted as soon as
+   * the optimization finishes.
+   **/
+  void enable_heuristic_callback(bool concurrent_scarp = true);
+
+  /**
+   * Records the Trajectory of the incumbent and the
+   * bound during subsequent solves.
+   **/
+  void enable_trajectory();
+
+  /**
+   * Returns the Trajectory of the last solve, which is
+   * empty unless enable_trajectory() was called.
+   **/
+  Trajectory get_trajectory() const;
+
+  /**
+   * Bounds the running time (in seconds) of solve().
+   **/
+  void set_time_limit(double time_limit);
+
+  /**
+   * Suggests a solution to be injected at the next node of a
+   * running solve(). Requires the heuristic callback to be
+   * enabled. May be called from any thread.
+   **/
+  void suggest_solution(const VertexMap<Controls>& controls);
+
+  /**
+   * Cooperatively terminates the running solve(), which then
+   * returns the incumbent. If a callback is in place, a solve()
+   * which is about to start is terminated as well. May be
+   * called from any thread.
+   **/
+  void terminate();
+
+  /**
+   * Returns whether the solution returned by the last
+   * call of solve() is proven to be optimal.
+   **/
+  bool is_optimal() const
+  {
+    return optimal;
+  }
+
+  /**
+   * Solves the model, returning the best solution found. Throws an
+   * std::runtime_error if no solution was found, e.g., because the
+   * time limit was reached or the solve was terminated beforehand.
+   **/
   VertexMap<Controls> solve();
 
+  /**
+   * Solves the LP relaxation of the model, yielding
+   * a lower bound on the optimal costs.
+   **/
+  double solve_relaxation();
+
+  /**
+   * Solves the LP relaxation, additionally storing
+   * the relaxed values of the controls.
+   **/
+  double solve_relaxation(VertexMap<Controls>& relaxed_controls);
+
+  /**
+   * Fixes the controls of the given vertices to the given
+   * (integral) values, restricting subsequent solves.
+   **/
+  void fix_controls(const VertexMap<Controls>& controls,
+                    const std::vector<Vertex>& vertices);
+
+  /**
+   * Releases all controls previously fixed by fix_controls().
+   **/
+  void release_controls();
+
+  /**
+   * Re-targets the model to the given fractional controls (on the same
+   * Graph) by updating right-hand sides and bounds in place. The
+   * previous solution is kept as a start if it remains feasible.
+   **/
+  void update_fractional_controls(const VertexMap<Controls>& fractional_controls);
+
   void set_initial_solution(const VertexMap<Controls>& initial_solution);
 };
 
 
+/**
+ * Computes a lower bound on the optimal costs based on the
+ * LP relaxation of the cumulative formulation.
+ **/
+double compute_lower_bound(const Graph& graph,
+                           const VertexMap<Controls>& fractional_controls,
+                           const CostFunction& costs);
+
 #endif /* DAG_PROGRAM_HH */
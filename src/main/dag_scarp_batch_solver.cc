@@ -1,16 +1,21 @@
 #include <fstream>
 #include <filesystem>
+#include <memory>
+#include <optional>
 
 #include <boost/program_options.hpp>
 namespace po = boost::program_options;
 
 #include "control_reader.hh"
 #include "control_writer.hh"
+#include "dag_program.hh"
 #include "grid.hh"
+#include "local_search.hh"
 #include "log.hh"
 #include "timer.hh"
 
 #include "scarp/scarp_program.hh"
+#include "sorted_scarp/sorted_program.hh"
 
 int main(int argc, char *argv[])
 {
@@ -22,12 +27,22 @@ int main(int argc, char *argv[])
   std::string output_name;
 
   bool vanishing_constraints = false;
+  bool lower_bound = false;
+  bool local_search = false;
+  bool sorted = false;
+  bool sequence = false;
 
   idx num_repeats = 1;
+  idx window = 0;
 
   desc.add_options()
     ("help", "produce help message")
     ("vanishing_constraints", po::bool_switch(&vanishing_constraints)->default_value(false), "enable vanishing constraints")
+    ("sorted", po::bool_switch(&sorted)->default_value(false), "deduplicate labels by sorting")
+    ("lower_bound", po::bool_switch(&lower_bound)->default_value(false), "report a lower bound based on the LP relaxation")
+    ("local_search", po::bool_switch(&local_search)->default_value(false), "improve the SCARP controls using a local search")
+    ("sequence", po::bool_switch(&sequence)->default_value(false), "treat the inputs as a sequence on the same grid, re-solving incrementally")
+    ("window", po::value<idx>(&window)->default_value(window), "size of the window of the rolling horizon (0 to disable)")
     ("repeats", po::value<idx>(&num_repeats)->default_value(num_repeats), "number of repeats")
     ("input", po::value<std::vector<std::string>>(&input_names)->required(), "input file")
     ("output", po::value<std::string>(&output_name)->required(), "output file");
@@ -57,36 +72,133 @@ int main(int argc, char *argv[])
 
   po::notify(vm);
 
+  if(sorted && window > 0)
+  {
+    std::cerr << "The rolling horizon is not supported for sorted labels" << std::endl;
+    return 1;
+  }
+
+  if(sequence && (sorted || num_repeats > 1))
+  {
+    std::cerr << "The sequence mode is not supported for sorted labels or repeats" << std::endl;
+    return 1;
+  }
+
   std::ofstream output(output_name);
 
-  output << "Name;Objective;Distance;UpperBound;RunningTime" << std::endl;
+  output << "Name;Objective;Distance;UpperBound;RunningTime";
+
+  if(lower_bound)
+  {
+    output << ";LowerBound;Gap";
+  }
+
+  if(local_search)
+  {
+    output << ";InitialObjective;Moves";
+  }
+
+  if(sequence)
+  {
+    output << ";ReadTime";
+  }
+
+  output << std::endl;
+
+  SequenceReader reader;
+
+  // retained between the steps of a sequence
+  std::unique_ptr<VariationalCosts> cost_function;
+  std::unique_ptr<SCARPProgram> scarp_program;
 
   for(const std::string& input_name : input_names)
   {
+    if(!sequence)
+    {
+      scarp_program.reset();
+      reader.reset();
+    }
+
+    Timer read_timer;
+
     std::ifstream input(input_name);
-    auto result = read_file(input);
+    const ReadResult& result = reader.read(input);
 
-    const idx grid_length = compute_grid_length(result.graph,
-                                                result.coordinates);
+    const double read_time = read_timer.elapsed();
 
-    const double scale_factor = 1. / ((double) grid_length);
+    const bool warm_start = sequence && scarp_program;
 
-    auto costs = VariationalCosts(scale_factor);
+    if(!warm_start)
+    {
+      const idx grid_length = compute_grid_length(result.graph,
+                                                  result.coordinates);
 
-    SCARPProgram program(result.graph,
-                         costs,
-                         result.fractional_controls);
+      const double scale_factor = 1. / ((double) grid_length);
+
+      cost_function = std::make_unique<VariationalCosts>(scale_factor);
+
+      scarp_program = std::make_unique<SCARPProgram>(result.graph,
+                                                     *cost_function,
+                                                     result.fractional_controls);
+    }
+
+    const VariationalCosts& costs = *cost_function;
+    SCARPProgram& program = *scarp_program;
+
+    std::optional<SortedProgram> sorted_program;
+
+    if(sorted)
+    {
+      sorted_program.emplace(result.graph,
+                             costs,
+                             result.fractional_controls,
+                             false,
+                             1);
+    }
+
+    auto solve = [&]() -> VertexMap<Controls>
+      {
+        if(window > 0)
+        {
+          return program.solve_rolling(window);
+        }
+
+        return sorted ? sorted_program->solve() : program.solve();
+      };
 
     Timer timer;
 
+    if(warm_start)
+    {
+      // only the affected suffix is re-solved
+      program.update_fractional_controls(result.fractional_controls);
+    }
+
     for(int i = 0; i < num_repeats - 1; ++i)
     {
-      program.solve();
+      solve();
     }
 
-    auto scarp_controls = program.solve();
+    auto scarp_controls = solve();
+
+    double elapsed = timer.elapsed() / ((double) num_repeats);
+
+    const double initial_cost = costs.evaluate(result.graph, scarp_controls);
+    idx num_moves = 0;
+
+    if(local_search)
+    {
+      Timer search_timer;
+
+      LocalSearch search(result.graph,
+                         costs,
+                         result.fractional_controls);
+
+      scarp_controls = search.improve(scarp_controls);
+      num_moves = search.get_num_moves();
 
-    const double elapsed = timer.elapsed() / ((double) num_repeats);
+      elapsed += search_timer.elapsed();
+    }
 
     const Vertex source = *result.graph.get_vertices().begin();
     const idx dimension = result.fractional_controls(source).size();
@@ -112,8 +224,37 @@ int main(int argc, char *argv[])
            << control_cost << ";"
            << distance << ";"
            << upper_bound << ";"
-           << elapsed
-           << std::endl;
+           << elapsed;
+
+    if(lower_bound)
+    {
+      const double cost_bound = compute_lower_bound(result.graph,
+                                                    result.fractional_controls,
+                                                    costs);
+
+      const double gap = (control_cost > 0.) ?
+        (control_cost - cost_bound) / control_cost :
+        0.;
+
+      output << ";"
+             << cost_bound << ";"
+             << gap;
+    }
+
+    if(local_search)
+    {
+      output << ";"
+             << initial_cost << ";"
+             << num_moves;
+    }
+
+    if(sequence)
+    {
+      output << ";"
+             << read_time;
+    }
+
+    output << std::endl;
   }
 
   return 0;
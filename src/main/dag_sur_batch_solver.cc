@@ -1,5 +1,6 @@
 #include <fstream>
 #include <filesystem>
+#include <map>
 
 #include <boost/program_options.hpp>
 namespace po = boost::program_options;
@@ -8,10 +9,14 @@ namespace po = boost::program_options;
 #include "control_writer.hh"
 
 #include "cost_function.hh"
+#include "dag_program.hh"
 #include "grid.hh"
+#include "local_search.hh"
 #include "log.hh"
 #include "timer.hh"
 
+#include "sur/batch_sur.hh"
+#include "sur/lookahead_sur.hh"
 #include "sur/sur.hh"
 
 int main(int argc, char *argv[])
@@ -24,12 +29,22 @@ int main(int argc, char *argv[])
   std::string output_name;
 
   bool vanishing_constraints = false;
+  bool lower_bound = false;
+  bool local_search = false;
+  bool vectorized = false;
+  bool sequence = false;
 
   idx num_repeats = 1;
+  idx lookahead = 0;
 
   desc.add_options()
     ("help", "produce help message")
     ("vanishing_constraints", po::bool_switch(&vanishing_constraints)->default_value(false), "enable vanishing constraints")
+    ("lower_bound", po::bool_switch(&lower_bound)->default_value(false), "report a lower bound based on the LP relaxation")
+    ("local_search", po::bool_switch(&local_search)->default_value(false), "improve the SUR controls using a local search")
+    ("vectorized", po::bool_switch(&vectorized)->default_value(false), "round all instances at once, reporting amortized running times")
+    ("sequence", po::bool_switch(&sequence)->default_value(false), "treat the inputs as a sequence on the same grid, reading the grid only once")
+    ("lookahead", po::value<idx>(&lookahead)->default_value(lookahead), "size of the window of the lookahead rounding (0 to disable)")
     ("repeats", po::value<idx>(&num_repeats)->default_value(num_repeats), "number of repeats")
     ("input", po::value<std::vector<std::string>>(&input_names)->required(), "input file")
     ("output", po::value<std::string>(&output_name)->required(), "output file");
@@ -59,14 +74,109 @@ int main(int argc, char *argv[])
 
   po::notify(vm);
 
+  if(vectorized && (lookahead > 0 || sequence))
+  {
+    std::cerr << "The lookahead rounding and the sequence mode cannot be vectorized" << std::endl;
+    return 1;
+  }
+
   std::ofstream output(output_name);
 
-  output << "Name;Objective;Distance;UpperBound;RunningTime" << std::endl;
+  output << "Name;Objective;Distance;UpperBound;RunningTime";
+
+  if(lower_bound)
+  {
+    output << ";LowerBound;Gap";
+  }
+
+  if(local_search)
+  {
+    output << ";InitialObjective;Moves";
+  }
+
+  if(sequence)
+  {
+    output << ";ReadTime";
+  }
+
+  output << std::endl;
+
+  auto read_instance = [](const std::string& input_name) -> ReadResult
+    {
+      std::ifstream input(input_name);
+      return read_file(input);
+    };
+
+  const idx num_instances = input_names.size();
 
-  for(const std::string& input_name : input_names)
+  SequenceReader reader;
+
+  // in vectorized mode, all instances are read and rounded in advance
+  std::vector<ReadResult> results;
+  std::vector<std::vector<std::uint8_t>> vectorized_controls(num_instances);
+  double vectorized_time = 0.;
+
+  if(vectorized)
   {
-    std::ifstream input(input_name);
-    auto result = read_file(input);
+    std::map<idx, std::vector<idx>> instances_by_dimension;
+
+    for(idx k = 0; k < num_instances; ++k)
+    {
+      results.push_back(read_instance(input_names[k]));
+
+      const Vertex source = *results[k].graph.get_vertices().begin();
+      const idx dimension = results[k].fractional_controls(source).size();
+
+      instances_by_dimension[dimension].push_back(k);
+    }
+
+    Timer timer;
+
+    for(const auto& [dimension, instances] : instances_by_dimension)
+    {
+      BatchSUR batch_sur(dimension);
+
+      for(const idx k : instances)
+      {
+        batch_sur.add(results[k].graph, results[k].fractional_controls);
+      }
+
+      std::vector<std::vector<std::uint8_t>> controls;
+
+      for(int i = 0; i < num_repeats; ++i)
+      {
+        controls = batch_sur.solve();
+      }
+
+      for(idx j = 0; j < instances.size(); ++j)
+      {
+        vectorized_controls[instances[j]] = std::move(controls[j]);
+      }
+    }
+
+    vectorized_time = timer.elapsed() / ((double) num_repeats * num_instances);
+  }
+
+  for(idx k = 0; k < num_instances; ++k)
+  {
+    const std::string& input_name = input_names[k];
+
+    auto read_next = [&]() -> const ReadResult&
+      {
+        if(!sequence)
+        {
+          reader.reset();
+        }
+
+        std::ifstream input(input_name);
+        return reader.read(input);
+      };
+
+    Timer read_timer;
+
+    const ReadResult& result = vectorized ? results[k] : read_next();
+
+    const double read_time = read_timer.elapsed();
 
     const idx grid_length = compute_grid_length(result.graph,
                                                 result.coordinates);
@@ -75,23 +185,55 @@ int main(int argc, char *argv[])
 
     auto costs = VariationalCosts(scale_factor);
 
+    const Vertex source = *result.graph.get_vertices().begin();
+    const idx dimension = result.fractional_controls(source).size();
+
+    auto round = [&]() -> VertexMap<Controls>
+      {
+        if(lookahead > 0)
+        {
+          return compute_lookahead_sur_controls(result.graph,
+                                                result.fractional_controls,
+                                                costs,
+                                                lookahead);
+        }
+
+        return compute_sur_controls(result.graph,
+                                    result.fractional_controls,
+                                    costs);
+      };
+
     Timer timer;
 
-    for(int i = 0; i < num_repeats - 1; ++i)
+    for(int i = 0; !vectorized && i < num_repeats - 1; ++i)
     {
-      compute_sur_controls(result.graph,
-                           result.fractional_controls,
-                           costs);
+      round();
     }
 
-    auto sur_controls = compute_sur_controls(result.graph,
-                                             result.fractional_controls,
-                                             costs);
+    auto sur_controls = vectorized ?
+      expand_controls(result.graph, vectorized_controls[k], dimension) :
+      round();
 
-    const double elapsed = timer.elapsed() / ((double) num_repeats);
+    double elapsed = vectorized ?
+      vectorized_time :
+      timer.elapsed() / ((double) num_repeats);
 
-    const Vertex source = *result.graph.get_vertices().begin();
-    const idx dimension = result.fractional_controls(source).size();
+    const double initial_cost = costs.evaluate(result.graph, sur_controls);
+    idx num_moves = 0;
+
+    if(local_search)
+    {
+      Timer search_timer;
+
+      LocalSearch search(result.graph,
+                         costs,
+                         result.fractional_controls);
+
+      sur_controls = search.improve(sur_controls);
+      num_moves = search.get_num_moves();
+
+      elapsed += search_timer.elapsed();
+    }
 
     const double upper_bound = max_control_deviation(dimension);
 
@@ -121,8 +263,37 @@ int main(int argc, char *argv[])
            << control_cost << ";"
            << distance << ";"
            << upper_bound << ";"
-           << elapsed
-           << std::endl;
+           << elapsed;
+
+    if(lower_bound)
+    {
+      const double cost_bound = compute_lower_bound(result.graph,
+                                                    result.fractional_controls,
+                                                    costs);
+
+      const double gap = (control_cost > 0.) ?
+        (control_cost - cost_bound) / control_cost :
+        0.;
+
+      output << ";"
+             << cost_bound << ";"
+             << gap;
+    }
+
+    if(local_search)
+    {
+      output << ";"
+             << initial_cost << ";"
+             << num_moves;
+    }
+
+    if(sequence)
+    {
+      output << ";"
+             << read_time;
+    }
+
+    output << std::endl;
   }
 
   return 0;
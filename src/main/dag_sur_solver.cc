@@ -1,4 +1,5 @@
 #include <fstream>
+#include <string>
 
 #include "control_reader.hh"
 #include "control_writer.hh"
@@ -11,6 +12,20 @@ int main(int argc, char *argv[])
 {
   log_init();
 
+  // rounds row by row without reading in the graph
+  if(argc == 4 && std::string(argv[1]) == "--stream")
+  {
+    std::ifstream input(argv[2]);
+    std::ofstream output(argv[3]);
+
+    const double distance = stream_sur_controls(input, output);
+
+    Log(info) << "Distance between controls: "
+              << distance;
+
+    return 0;
+  }
+
   std::ifstream input(argv[1]);
   std::ofstream output(argv[2]);
 
@@ -0,0 +1,278 @@
+#include "decomposition.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <thread>
+
+#include "cmp.hh"
+#include "control_sums.hh"
+#include "log.hh"
+#include "reordering.hh"
+#include "timer.hh"
+
+DecompositionSolver::DecompositionSolver(const Graph& graph,
+                                         const CostFunction& costs,
+                                         const VertexMap<Controls>& fractional_controls,
+                                         const VertexMap<Point>& coordinates,
+                                         const TileSolver& tile_solver,
+                                         idx tile_size,
+                                         idx overlap,
+                                         idx num_threads)
+  : graph(graph),
+    costs(costs),
+    fractional_controls(fractional_controls),
+    coordinates(coordinates),
+    tile_solver(tile_solver),
+    tile_size(tile_size),
+    overlap(overlap),
+    num_threads(std::max(num_threads, (idx) 1)),
+    source(*graph.get_vertices().begin()),
+    dimension(fractional_controls(source).size()),
+    upper_bound(max_control_deviation(dimension)),
+    num_tiles(0),
+    num_failed(0),
+    num_repaired(0)
+{
+  assert(controls_are_convex(graph, fractional_controls));
+
+  if(tile_size == 0)
+  {
+    throw std::invalid_argument("Tile size must be positive");
+  }
+}
+
+std::vector<DecompositionSolver::Tile> DecompositionSolver::compute_tiles() const
+{
+  idx min_i = std::numeric_limits<idx>::max();
+  idx min_j = std::numeric_limits<idx>::max();
+
+  for(const Vertex& vertex : graph.get_vertices())
+  {
+    min_i = std::min(min_i, coordinates(vertex).get_i());
+    min_j = std::min(min_j, coordinates(vertex).get_j());
+  }
+
+  // the tiles (without the overlap) containing at least one vertex
+  std::map<std::pair<idx, idx>, idx> tile_indices;
+
+  for(const Vertex& vertex : graph.get_vertices())
+  {
+    const idx i = coordinates(vertex).get_i() - min_i;
+    const idx j = coordinates(vertex).get_j() - min_j;
+
+    tile_indices.insert(std::make_pair(std::make_pair(i / tile_size, j / tile_size),
+                                       tile_indices.size()));
+  }
+
+  std::vector<Tile> tiles(tile_indices.size());
+
+  // the range of tiles whose extension contains the given position
+  auto tile_range = [&](idx position) -> std::pair<idx, idx>
+    {
+      const idx first = (position >= overlap) ? (position - overlap) / tile_size : 0;
+      const idx last = (position + overlap) / tile_size;
+
+      return std::make_pair(first, last);
+    };
+
+  for(const Vertex& vertex : graph.get_vertices())
+  {
+    const idx i = coordinates(vertex).get_i() - min_i;
+    const idx j = coordinates(vertex).get_j() - min_j;
+
+    tiles[tile_indices.at(std::make_pair(i / tile_size, j / tile_size))].core_vertices.push_back(vertex);
+
+    const auto [first_i, last_i] = tile_range(i);
+    const auto [first_j, last_j] = tile_range(j);
+
+    for(idx tile_i = first_i; tile_i <= last_i; ++tile_i)
+    {
+      for(idx tile_j = first_j; tile_j <= last_j; ++tile_j)
+      {
+        auto it = tile_indices.find(std::make_pair(tile_i, tile_j));
+
+        if(it != std::end(tile_indices))
+        {
+          tiles[it->second].vertices.push_back(vertex);
+        }
+      }
+    }
+  }
+
+  return tiles;
+}
+
+void DecompositionSolver::solve_tile(const Tile& tile, VertexMap<Controls>& controls) const
+{
+  const Reordering reordering = induce_subgraph(graph, tile.vertices);
+
+  MappedCosts tile_costs(costs,
+                         reordering.original_edges,
+                         reordering.reversed_edges);
+
+  const VertexMap<Controls> tile_fractional_controls = reorder_controls(reordering,
+                                                                        fractional_controls);
+
+  const VertexMap<Controls> tile_controls = tile_solver(reordering.graph,
+                                                        tile_costs,
+                                                        tile_fractional_controls);
+
+  // each core vertex belongs to exactly one tile
+  for(const Vertex& vertex : tile.core_vertices)
+  {
+    controls(vertex) = tile_controls(reordering.reordered_vertices(vertex));
+  }
+}
+
+VertexMap<Controls> DecompositionSolver::repair(const VertexMap<Controls>& controls)
+{
+  const SumOracle sum_oracle(graph, fractional_controls, upper_bound);
+
+  VertexMap<Controls> repaired_controls(graph, Controls(dimension, 0.));
+
+  std::vector<idx> control_sums(dimension, 0);
+
+  num_repaired = 0;
+
+  idx index = 0;
+
+  for(const Vertex& vertex : graph.get_vertices())
+  {
+    const Controls& current_controls = controls(vertex);
+
+    const idx current_control = std::max_element(std::begin(current_controls),
+                                                  std::end(current_controls)) -
+      std::begin(current_controls);
+
+    // the vertices of tiles which failed to solve are unassigned
+    const bool assigned = std::any_of(std::begin(current_controls),
+                                      std::end(current_controls),
+                                      [](double value) { return cmp::eq(value, 1.); });
+
+    ++control_sums[current_control];
+
+    idx control = current_control;
+
+    if(!assigned || !sum_oracle.is_viable(index, control_sums))
+    {
+      --control_sums[current_control];
+
+      double best_cost = inf;
+
+      for(idx i = 0; i < dimension; ++i)
+      {
+        ++control_sums[i];
+
+        if(sum_oracle.is_viable(index, control_sums))
+        {
+          Controls next_controls(dimension, 0.);
+          next_controls[i] = 1.;
+
+          double cost = 0.;
+
+          for(const Edge& incoming : graph.get_incoming(vertex))
+          {
+            cost += costs(incoming,
+                          repaired_controls(incoming.get_source()),
+                          next_controls);
+          }
+
+          if(cost < best_cost)
+          {
+            best_cost = cost;
+            control = i;
+          }
+        }
+
+        --control_sums[i];
+      }
+
+      // viable sums can always be extended
+      assert(best_cost < inf);
+
+      ++control_sums[control];
+      ++num_repaired;
+    }
+
+    repaired_controls(vertex).at(control) = 1.;
+
+    ++index;
+  }
+
+  return repaired_controls;
+}
+
+VertexMap<Controls> DecompositionSolver::solve()
+{
+  Timer timer;
+
+  const std::vector<Tile> tiles = compute_tiles();
+
+  num_tiles = tiles.size();
+  num_failed = 0;
+
+  VertexMap<Controls> controls(graph, Controls(dimension, 0.));
+
+  std::atomic<idx> next_tile(0);
+
+  auto solve_tiles = [&]()
+    {
+      for(idx k = next_tile++; k < tiles.size(); k = next_tile++)
+      {
+        try
+        {
+          solve_tile(tiles[k], controls);
+        }
+        catch(const std::runtime_error& exc)
+        {
+          // the core vertices are assigned during the repair
+          Log(error) << "Failed to solve tile "
+                     << k
+                     << ": "
+                     << exc.what();
+
+          ++num_failed;
+        }
+      }
+    };
+
+  std::vector<std::thread> workers;
+
+  for(idx worker = 1; worker < std::min(num_threads, num_tiles); ++worker)
+  {
+    workers.emplace_back(solve_tiles);
+  }
+
+  solve_tiles();
+
+  for(std::thread& worker : workers)
+  {
+    worker.join();
+  }
+
+  const double tile_time = timer.elapsed();
+
+  VertexMap<Controls> repaired_controls = repair(controls);
+
+  Log(info) << "Solved "
+            << num_tiles
+            << " tiles ("
+            << num_failed
+            << " failed) in "
+            << tile_time
+            << "s, repaired "
+            << num_repaired
+            << " vertices in "
+            << (timer.elapsed() - tile_time)
+            << "s";
+
+  assert(controls_are_integral(graph, repaired_controls));
+  assert(controls_are_convex(graph, repaired_controls));
+  assert(cmp::le(control_distance(graph, fractional_controls, repaired_controls),
+                 upper_bound));
+
+  return repaired_controls;
+}
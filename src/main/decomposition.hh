@@ -0,0 +1,118 @@
+#ifndef DECOMPOSITION_HH
+#define DECOMPOSITION_HH
+
+#include <atomic>
+#include <functional>
+#include <vector>
+
+#include "controls.hh"
+#include "cost_function.hh"
+#include "point.hh"
+#include "graph/graph.hh"
+#include "graph/vertex_map.hh"
+
+/**
+ * A solver for the tiles of a DecompositionSolver, e.g., based on
+ * a SCARPProgram or an ExactProgram. Throws an std::runtime_error
+ * if the tile cannot be solved.
+ **/
+typedef std::function<VertexMap<Controls>(const Graph& graph,
+                                          const CostFunction& costs,
+                                          const VertexMap<Controls>& fractional_controls)> TileSolver;
+
+/**
+ * A spatial decomposition of large grids: The grid is partitioned
+ * into square tiles of a given size (with respect to the coordinates
+ * of the vertices). Each tile is extended by the given overlap
+ * on all sides and the subgraphs induced by the extended tiles are
+ * solved in parallel. The controls of each vertex are then taken
+ * from the tile containing it (without the overlap).
+ *
+ * Since the approximation constraints refer to the prefixes of all
+ * vertices, the stitched controls may violate the upper bound. They
+ * are therefore repaired in a forward pass: The control of each
+ * vertex is retained as long as the control sums remain viable with
+ * respect to a SumOracle, otherwise the cheapest viable control
+ * is chosen instead. The controls of the vertices of tiles which
+ * fail to solve are chosen in the same way.
+ **/
+class DecompositionSolver
+{
+private:
+  const Graph& graph;
+  const CostFunction& costs;
+  const VertexMap<Controls>& fractional_controls;
+  const VertexMap<Point>& coordinates;
+
+  const TileSolver tile_solver;
+
+  const idx tile_size;
+  const idx overlap;
+  const idx num_threads;
+
+  const Vertex source;
+  const idx dimension;
+  const double upper_bound;
+
+  idx num_tiles;
+  std::atomic<idx> num_failed;
+  idx num_repaired;
+
+  struct Tile
+  {
+    // the vertices of the tile including the overlap, in ascending order
+    std::vector<Vertex> vertices;
+    // the vertices whose controls are taken from the tile
+    std::vector<Vertex> core_vertices;
+  };
+
+  std::vector<Tile> compute_tiles() const;
+
+  void solve_tile(const Tile& tile, VertexMap<Controls>& controls) const;
+
+  VertexMap<Controls> repair(const VertexMap<Controls>& controls);
+
+public:
+  /**
+   * Constructs a new DecompositionSolver, solving tiles of
+   * the given size using the given number of threads.
+   **/
+  DecompositionSolver(const Graph& graph,
+                      const CostFunction& costs,
+                      const VertexMap<Controls>& fractional_controls,
+                      const VertexMap<Point>& coordinates,
+                      const TileSolver& tile_solver,
+                      idx tile_size,
+                      idx overlap = 0,
+                      idx num_threads = 1);
+
+  VertexMap<Controls> solve();
+
+  /**
+   * Returns the number of tiles of the last solve.
+   **/
+  idx get_num_tiles() const
+  {
+    return num_tiles;
+  }
+
+  /**
+   * Returns the number of tiles which failed to solve during
+   * the last solve.
+   **/
+  idx get_num_failed() const
+  {
+    return num_failed;
+  }
+
+  /**
+   * Returns the number of vertices whose controls
+   * were changed during the last repair.
+   **/
+  idx get_num_repaired() const
+  {
+    return num_repaired;
+  }
+};
+
+#endif /* DECOMPOSITION_HH */
@@ -0,0 +1,110 @@
+#include "environment_pool.hh"
+
+#include "log.hh"
+
+EnvironmentLease::EnvironmentLease(EnvironmentLease&& other)
+  : pool(other.pool),
+    env(other.env)
+{
+  other.pool = nullptr;
+  other.env = nullptr;
+}
+
+EnvironmentLease& EnvironmentLease::operator=(EnvironmentLease&& other)
+{
+  if(this != &other)
+  {
+    if(pool)
+    {
+      pool->release(*env);
+    }
+
+    pool = other.pool;
+    env = other.env;
+
+    other.pool = nullptr;
+    other.env = nullptr;
+  }
+
+  return *this;
+}
+
+EnvironmentLease::~EnvironmentLease()
+{
+  if(pool)
+  {
+    pool->release(*env);
+  }
+}
+
+EnvironmentPool::EnvironmentPool()
+  : threads(0),
+    time_limit(inf)
+{
+}
+
+EnvironmentPool& EnvironmentPool::get_instance()
+{
+  static EnvironmentPool pool;
+  return pool;
+}
+
+void EnvironmentPool::configure(GRBEnv& env) const
+{
+  env.set(GRB_IntParam_Threads, threads);
+  env.set(GRB_DoubleParam_TimeLimit, time_limit == inf ? GRB_INFINITY : time_limit);
+}
+
+void EnvironmentPool::set_threads(idx threads)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+
+  this->threads = threads;
+
+  for(auto& env : environments)
+  {
+    configure(*env);
+  }
+}
+
+void EnvironmentPool::set_time_limit(double time_limit)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+
+  this->time_limit = time_limit;
+
+  for(auto& env : environments)
+  {
+    configure(*env);
+  }
+}
+
+EnvironmentLease EnvironmentPool::acquire()
+{
+  std::lock_guard<std::mutex> lock(mutex);
+
+  if(available.empty())
+  {
+    Log(debug) << "Starting Gurobi environment " << environments.size();
+
+    environments.push_back(std::make_unique<GRBEnv>());
+
+    GRBEnv& env = *environments.back();
+
+    configure(env);
+
+    return EnvironmentLease(*this, env);
+  }
+
+  GRBEnv* env = available.back();
+  available.pop_back();
+
+  return EnvironmentLease(*this, *env);
+}
+
+void EnvironmentPool::release(GRBEnv& env)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+
+  available.push_back(&env);
+}
@@ -0,0 +1,108 @@
+#ifndef ENVIRONMENT_POOL_HH
+#define ENVIRONMENT_POOL_HH
+
+#include <cassert>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <gurobi_c++.h>
+
+#include "util.hh"
+
+class EnvironmentPool;
+
+/**
+ * A Gurobi environment borrowed from an EnvironmentPool,
+ * which is returned to the pool on destruction.
+ **/
+class EnvironmentLease
+{
+private:
+  EnvironmentPool* pool;
+  GRBEnv* env;
+
+public:
+  EnvironmentLease()
+    : pool(nullptr),
+      env(nullptr)
+  {}
+
+  EnvironmentLease(EnvironmentPool& pool, GRBEnv& env)
+    : pool(&pool),
+      env(&env)
+  {}
+
+  /**
+   * Wraps an environment which is not owned by any pool.
+   **/
+  explicit EnvironmentLease(GRBEnv& env)
+    : pool(nullptr),
+      env(&env)
+  {}
+
+  EnvironmentLease(const EnvironmentLease&) = delete;
+  EnvironmentLease& operator=(const EnvironmentLease&) = delete;
+
+  EnvironmentLease(EnvironmentLease&& other);
+  EnvironmentLease& operator=(EnvironmentLease&& other);
+
+  ~EnvironmentLease();
+
+  GRBEnv& get() const
+  {
+    assert(env);
+    return *env;
+  }
+};
+
+/**
+ * A process-wide pool of Gurobi environments. Starting an environment
+ * (including the license check) is expensive, the environments are
+ * therefore started once and shared by subsequently created models.
+ * Parameters (threads, time limits) are set on all environments of
+ * the pool, they apply to models created afterwards.
+ **/
+class EnvironmentPool
+{
+private:
+  std::mutex mutex;
+
+  std::vector<std::unique_ptr<GRBEnv>> environments;
+  std::vector<GRBEnv*> available;
+
+  idx threads;
+  double time_limit;
+
+  void configure(GRBEnv& env) const;
+
+  void release(GRBEnv& env);
+
+  friend class EnvironmentLease;
+
+public:
+  EnvironmentPool();
+
+  EnvironmentPool(const EnvironmentPool&) = delete;
+  EnvironmentPool& operator=(const EnvironmentPool&) = delete;
+
+  static EnvironmentPool& get_instance();
+
+  /**
+   * Sets the number of threads (0: automatic).
+   **/
+  void set_threads(idx threads);
+
+  /**
+   * Sets the time limit in seconds.
+   **/
+  void set_time_limit(double time_limit);
+
+  /**
+   * Borrows an environment, starting a new one
+   * if all environments are in use.
+   **/
+  EnvironmentLease acquire();
+};
+
+#endif /* ENVIRONMENT_POOL_HH */
@@ -1,16 +1,20 @@
 #include "exact_program.hh"
 
 #include <algorithm>
+#include <limits>
 #include <sstream>
 
 #include "cmp.hh"
 #include "log.hh"
+#include "timer.hh"
 #include "graph/vertex_map.hh"
 
 VertexMap<idx> get_prefix_map(const Graph& graph)
 {
   VertexMap<idx> prefix_map(graph, 0);
 
+  // The labels of the vertex preceding the target of an Edge
+  // have to store all controls back to the source of the Edge
   for(const Vertex& vertex : graph.get_vertices())
   {
     const idx vertex_index = vertex.get_index();
@@ -21,8 +25,10 @@ VertexMap<idx> get_prefix_map(const Graph& graph)
 
       assert(vertex_index > source_index);
 
-      prefix_map(vertex) = std::max(prefix_map(vertex),
-                                    vertex_index -source_index);
+      const Vertex previous = graph.get_vertices()[vertex_index - 1];
+
+      prefix_map(previous) = std::max(prefix_map(previous),
+                                      vertex_index - source_index);
     }
   }
 
@@ -63,15 +69,38 @@ VertexMap<idx> get_prefix_map(const Graph& graph)
   return prefix_map;
 }
 
+VertexMap<idx> get_prefix_map(const Graph& graph,
+                              idx history_length)
+{
+  assert(history_length >= 1);
+
+  VertexMap<idx> prefix_map = get_prefix_map(graph);
+
+  for(const Vertex& vertex : graph.get_vertices())
+  {
+    prefix_map(vertex) = std::min(prefix_map(vertex), history_length);
+  }
+
+  return prefix_map;
+}
+
+const idx ExactProgram::unbounded_history = std::numeric_limits<idx>::max();
+
 ExactProgram::ExactProgram(const Graph& graph,
                            const CostFunction& costs,
                            const VertexMap<Controls>& fractional_controls,
-                           bool vanishing_constraints)
+                           bool vanishing_constraints,
+                           idx history_length)
   : graph(graph),
-    prefix_map(get_prefix_map(graph)),
+    prefix_map(get_prefix_map(graph, history_length)),
     costs(costs),
     fractional_controls(fractional_controls),
     vanishing_constraints(vanishing_constraints),
+    bounded_history(history_length != unbounded_history),
+    time_limit(inf),
+    label_limit(std::numeric_limits<idx>::max()),
+    interrupt(nullptr),
+    optimal(false),
     source(*graph.get_vertices().begin()),
     dimension(fractional_controls(source).size()),
     upper_bound(max_control_deviation(dimension)),
@@ -134,7 +163,7 @@ void ExactProgram::create_initial_labels()
   }
 }
 
-void ExactProgram::expand(Vertex source, Vertex target)
+void ExactProgram::expand(Vertex source, Vertex target, idx prefix_length)
 {
   Controls previous_controls(dimension, 0.);
   Controls next_controls(dimension, 0.);
@@ -187,7 +216,7 @@ void ExactProgram::expand(Vertex source, Vertex target)
               auto next_label = std::make_shared<ExactLabel>(j,
                                                              target,
                                                              0.,
-                                                             prefix_map(target),
+                                                             prefix_length,
                                                              label);
 
               double label_dist = label_distance(next_label);
@@ -241,7 +270,7 @@ void ExactProgram::expand(Vertex source, Vertex target)
           auto next_label = std::make_shared<ExactLabel>(j,
                                                          target,
                                                          label->get_cost() + additional_cost,
-                                                         prefix_map(target),
+                                                         prefix_length,
                                                          label);
 
           auto it = target_labels.at(j).find(next_label);
@@ -299,6 +328,10 @@ void ExactProgram::expand_all()
 
   add_fractional_controls(source);
 
+  Timer timer;
+
+  bool budget_exceeded = false;
+
   for(; target_it != end_it; ++source_it, ++target_it)
   {
     Vertex source = *source_it;
@@ -322,10 +355,26 @@ void ExactProgram::expand_all()
 
     add_fractional_controls(target);
 
-    expand(source, target);
+    if(!budget_exceeded &&
+       (num_labels > label_limit ||
+        timer.elapsed() > time_limit ||
+        (interrupt && *interrupt)))
+    {
+      Log(info) << "Budget exceeded after creating "
+                << num_labels
+                << " labels, continuing with a history length of one";
+
+      budget_exceeded = true;
+    }
+
+    expand(source,
+           target,
+           budget_exceeded ? 1 : prefix_map(target));
 
     labels(source).clear();
   }
+
+  optimal = !(budget_exceeded || bounded_history);
 }
 
 double ExactProgram::get_costs(ExactLabelPtr label)
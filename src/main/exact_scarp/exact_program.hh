@@ -1,6 +1,8 @@
 #ifndef EXACT_PROGRAM_HH
 #define EXACT_PROGRAM_HH
 
+#include <atomic>
+#include <limits>
 #include <memory>
 
 #include <set>
@@ -12,6 +14,30 @@
 
 #include "cost_function.hh"
 
+/**
+ * Returns for each vertex the length of the prefix of controls
+ * stored in the labels of the ExactProgram, which depends on how
+ * far the Edge%s entering subsequent vertices reach back in the
+ * vertex order.
+ **/
+VertexMap<idx> get_prefix_map(const Graph& graph);
+
+/**
+ * Returns the prefix map of the given Graph with all
+ * prefix lengths bounded by the given history length.
+ **/
+VertexMap<idx> get_prefix_map(const Graph& graph,
+                              idx history_length);
+
+/**
+ * A labeling algorithm whose labels store the control sums together
+ * with a prefix of the most recent controls. Two labels are only
+ * merged if they agree on both. With an unbounded history length,
+ * the prefixes cover all Edge%s reaching back and the
+ * solution is optimal. A history length of one yields the labels
+ * of the SCARPProgram, intermediate lengths trade
+ * running time against the quality of the solution.
+ **/
 class ExactProgram
 {
 public:
@@ -29,6 +55,14 @@ private:
 
   bool vanishing_constraints;
 
+  const bool bounded_history;
+
+  double time_limit;
+  idx label_limit;
+  const std::atomic<bool>* interrupt;
+
+  bool optimal;
+
   const Vertex source;
   const idx dimension;
   const double upper_bound;
@@ -41,7 +75,7 @@ private:
 
   void create_initial_labels();
 
-  void expand(Vertex source, Vertex target);
+  void expand(Vertex source, Vertex target, idx prefix_length);
 
   void expand_all();
 
@@ -59,7 +93,50 @@ public:
   ExactProgram(const Graph& graph,
                const CostFunction& costs,
                const VertexMap<Controls>& fractional_controls,
-               bool vanishing_constraints = false);
+               bool vanishing_constraints = false,
+               idx history_length = unbounded_history);
+
+  static const idx unbounded_history;
+
+  /**
+   * Bounds the running time (in seconds) of solve(). Once the
+   * time limit is exceeded, the remaining vertices are labeled
+   * with a history length of one.
+   **/
+  void set_time_limit(double time_limit)
+  {
+    this->time_limit = time_limit;
+  }
+
+  /**
+   * Bounds the number of labels created during solve(). Once the
+   * label limit is exceeded, the remaining vertices are labeled
+   * with a history length of one.
+   **/
+  void set_label_limit(idx label_limit)
+  {
+    this->label_limit = label_limit;
+  }
+
+  /**
+   * Sets a flag which may be raised from another thread while
+   * solve() is running, taking the same effect as an
+   * exceeded budget.
+   **/
+  void set_interrupt(const std::atomic<bool>* interrupt)
+  {
+    this->interrupt = interrupt;
+  }
+
+  /**
+   * Returns whether the solution returned by the last call
+   * of solve() is optimal, i.e., whether the history is
+   * unbounded and no budget was exceeded.
+   **/
+  bool is_optimal() const
+  {
+    return optimal;
+  }
 
   VertexMap<Controls> solve();
 };
@@ -0,0 +1,94 @@
+#include "reordered_program.hh"
+
+#include <map>
+#include <sstream>
+
+#include "cmp.hh"
+#include "log.hh"
+
+std::string prefix_histogram(const Graph& graph)
+{
+  VertexMap<idx> prefix_map = get_prefix_map(graph);
+
+  std::map<idx, idx> histogram;
+
+  idx max_prefix_length = 0;
+
+  for(const Vertex& vertex : graph.get_vertices())
+  {
+    ++histogram[prefix_map(vertex)];
+    max_prefix_length = std::max(max_prefix_length, prefix_map(vertex));
+  }
+
+  std::ostringstream buf;
+
+  buf << "maximum " << max_prefix_length << ",";
+
+  for(const auto& [prefix_length, count] : histogram)
+  {
+    buf << " " << prefix_length << ":" << count;
+  }
+
+  return buf.str();
+}
+
+ReorderedProgram::ReorderedProgram(const Graph& graph,
+                                   const CostFunction& costs,
+                                   const VertexMap<Controls>& fractional_controls,
+                                   bool vanishing_constraints,
+                                   idx history_length)
+  : graph(graph),
+    fractional_controls(fractional_controls),
+    reordering(reorder_graph(graph, compute_bandwidth_order(graph))),
+    reordered(false),
+    feasible(false),
+    reordered_costs(costs,
+                    reordering.original_edges,
+                    reordering.reversed_edges),
+    reordered_controls(reorder_controls(reordering, fractional_controls)),
+    program(reordering.graph,
+            reordered_costs,
+            reordered_controls,
+            vanishing_constraints,
+            history_length)
+{
+  for(const Vertex& vertex : graph.get_vertices())
+  {
+    if(reordering.reordered_vertices(vertex) != vertex)
+    {
+      reordered = true;
+      break;
+    }
+  }
+
+  Log(info) << "Prefix lengths before reordering: "
+            << prefix_histogram(graph);
+
+  Log(info) << "Prefix lengths after reordering: "
+            << prefix_histogram(reordering.graph);
+}
+
+VertexMap<Controls> ReorderedProgram::solve()
+{
+  VertexMap<Controls> controls = restore_controls(reordering,
+                                                  graph,
+                                                  program.solve());
+
+  const Vertex source = *graph.get_vertices().begin();
+  const idx dimension = fractional_controls(source).size();
+
+  const double distance = control_distance(graph,
+                                           fractional_controls,
+                                           controls);
+
+  feasible = cmp::le(distance, max_control_deviation(dimension));
+
+  if(!feasible)
+  {
+    Log(warning) << "Solution of the reordered program violates "
+                 << "the approximation constraints with a distance of "
+                 << distance;
+  }
+
+  return controls;
+}
@@ -0,0 +1,80 @@
+#ifndef REORDERED_PROGRAM_HH
+#define REORDERED_PROGRAM_HH
+
+#include <string>
+
+#include "exact_program.hh"
+
+#include "controls.hh"
+#include "cost_function.hh"
+#include "reordering.hh"
+
+/**
+ * Solves the ExactProgram on a copy of the Graph whose vertices
+ * have been reordered to reduce the bandwidth (and therefore the
+ * prefix lengths of the labels). The new order is a topological
+ * order of the DAG, the solution is mapped back to the original
+ * vertices. Note that the approximation constraints are enforced
+ * with respect to the new vertex order: The solution is therefore
+ * checked against the original order and is only optimal if the
+ * order remains unchanged.
+ **/
+class ReorderedProgram
+{
+private:
+  const Graph& graph;
+  const VertexMap<Controls>& fractional_controls;
+
+  Reordering reordering;
+  bool reordered;
+  bool feasible;
+  MappedCosts reordered_costs;
+  VertexMap<Controls> reordered_controls;
+
+  ExactProgram program;
+
+public:
+  ReorderedProgram(const Graph& graph,
+                   const CostFunction& costs,
+                   const VertexMap<Controls>& fractional_controls,
+                   bool vanishing_constraints = false,
+                   idx history_length = ExactProgram::unbounded_history);
+
+  const Reordering& get_reordering() const
+  {
+    return reordering;
+  }
+
+  ExactProgram& get_program()
+  {
+    return program;
+  }
+
+  /**
+   * Returns whether the solution returned by the last call of
+   * solve() satisfies the approximation constraints with
+   * respect to the original vertex order.
+   **/
+  bool is_feasible() const
+  {
+    return feasible;
+  }
+
+  /**
+   * Returns whether the solution returned by the last call of
+   * solve() is optimal for the original vertex order.
+   **/
+  bool is_optimal() const
+  {
+    return feasible && !reordered && program.is_optimal();
+  }
+
+  VertexMap<Controls> solve();
+};
+
+/**
+ * Returns a textual histogram of the prefix lengths of the given Graph.
+ **/
+std::string prefix_histogram(const Graph& graph);
+
+#endif /* REORDERED_PROGRAM_HH */
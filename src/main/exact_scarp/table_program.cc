@@ -0,0 +1,356 @@
+#include "table_program.hh"
+
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+
+#include "cmp.hh"
+#include "log.hh"
+
+std::optional<VertexMap<idx>> compute_sweep_slots(const Graph& graph,
+                                                  const VertexMap<Point>& coordinates)
+{
+  for(bool rows_along_i : {true, false})
+  {
+    VertexMap<idx> slots(graph, 0);
+
+    idx min_slot = std::numeric_limits<idx>::max();
+
+    for(const Vertex& vertex : graph.get_vertices())
+    {
+      const Point& point = coordinates(vertex);
+
+      slots(vertex) = rows_along_i ? point.get_i() : point.get_j();
+
+      min_slot = std::min(min_slot, slots(vertex));
+    }
+
+    for(const Vertex& vertex : graph.get_vertices())
+    {
+      slots(vertex) -= min_slot;
+    }
+
+    // The most recent vertex of each slot
+    std::unordered_map<idx, Vertex> occupants;
+
+    bool valid = true;
+
+    for(const Vertex& vertex : graph.get_vertices())
+    {
+      for(const Edge& incoming : graph.get_incoming(vertex))
+      {
+        const Vertex source = incoming.get_source();
+
+        auto it = occupants.find(slots(source));
+
+        if(it == std::end(occupants) || it->second != source)
+        {
+          valid = false;
+          break;
+        }
+      }
+
+      if(!valid)
+      {
+        break;
+      }
+
+      occupants[slots(vertex)] = vertex;
+    }
+
+    if(valid)
+    {
+      return slots;
+    }
+  }
+
+  return {};
+}
+
+namespace
+{
+  VertexMap<idx> get_sweep_slots(const Graph& graph,
+                                 const VertexMap<Point>& coordinates)
+  {
+    auto slots = compute_sweep_slots(graph, coordinates);
+
+    if(!slots)
+    {
+      throw std::invalid_argument("Graph is not swept row by row");
+    }
+
+    return *slots;
+  }
+}
+
+const std::size_t TableProgram::max_states = 1 << 22;
+
+TableProgram::TableProgram(const Graph& graph,
+                           const CostFunction& costs,
+                           const VertexMap<Controls>& fractional_controls,
+                           const VertexMap<Point>& coordinates,
+                           bool vanishing_constraints)
+  : graph(graph),
+    costs(costs),
+    fractional_controls(fractional_controls),
+    vanishing_constraints(vanishing_constraints),
+    source(*graph.get_vertices().begin()),
+    dimension(fractional_controls(source).size()),
+    upper_bound(max_control_deviation(dimension)),
+    slots(get_sweep_slots(graph, coordinates)),
+    num_slots(0),
+    num_window_states(1),
+    cost_tables(tabulate_costs(graph, costs, dimension))
+{
+  assert(controls_are_convex(graph, fractional_controls));
+
+  if(dimension > std::numeric_limits<std::uint8_t>::max())
+  {
+    throw std::invalid_argument("Dimension is too large");
+  }
+
+  for(const Vertex& vertex : graph.get_vertices())
+  {
+    num_slots = std::max(num_slots, slots(vertex) + 1);
+  }
+
+  for(idx slot = 0; slot < num_slots; ++slot)
+  {
+    strides.push_back(num_window_states);
+
+    num_window_states *= dimension;
+
+    if(num_window_states > max_states)
+    {
+      throw std::invalid_argument("Too many window states");
+    }
+  }
+
+  Log(debug) << "Created " << num_slots << " slots with "
+             << num_window_states << " window states";
+}
+
+bool TableProgram::is_allowed(const Vertex& vertex, idx control) const
+{
+  return !(vanishing_constraints && cmp::zero(fractional_controls(vertex).at(control)));
+}
+
+VertexMap<Controls> TableProgram::solve()
+{
+  const std::vector<SumLayer> sum_layers = compute_sum_layers(graph,
+                                                              fractional_controls,
+                                                              upper_bound);
+
+  for(const SumLayer& sum_layer : sum_layers)
+  {
+    if(sum_layer.size * num_window_states > max_states)
+    {
+      throw std::invalid_argument("Too many states");
+    }
+  }
+
+  const idx num_vertices = graph.get_vertices().size();
+
+  const std::size_t invalid = std::numeric_limits<std::size_t>::max();
+
+  std::vector<double> current_costs;
+  std::vector<double> next_costs;
+
+  // The previous control of the slot of the respective vertex
+  std::vector<std::vector<std::uint8_t>> previous_controls(num_vertices);
+
+  {
+    const SumLayer& sum_layer = sum_layers.front();
+
+    current_costs.assign(sum_layer.size * num_window_states, inf);
+
+    std::vector<idx> control_sums(dimension, 0);
+
+    for(idx i = 0; i < dimension; ++i)
+    {
+      control_sums.at(i) = 1;
+
+      auto sum_code = sum_layer.encode(control_sums);
+
+      if(is_allowed(source, i) && sum_code)
+      {
+        current_costs[(*sum_code) * num_window_states + i * strides[slots(source)]] = 0.;
+      }
+
+      control_sums.at(i) = 0;
+    }
+  }
+
+  struct Incoming
+  {
+    std::size_t stride;
+    bool same_slot;
+    const double* cost_table;
+  };
+
+  std::vector<Incoming> incoming_edges;
+
+  // transitions between the codes of the control sums
+  std::vector<std::size_t> transitions;
+
+  idx num_states = 0;
+
+  for(idx index = 1; index < num_vertices; ++index)
+  {
+    const Vertex vertex = graph.get_vertices()[index];
+
+    const SumLayer& previous_layer = sum_layers[index - 1];
+    const SumLayer& next_layer = sum_layers[index];
+
+    const std::size_t stride = strides[slots(vertex)];
+
+    transitions.assign(previous_layer.size * dimension, invalid);
+
+    for(std::size_t sum_code = 0; sum_code < previous_layer.size; ++sum_code)
+    {
+      std::vector<idx> control_sums = previous_layer.decode(sum_code);
+
+      for(idx i = 0; i < dimension; ++i)
+      {
+        ++control_sums[i];
+
+        auto next_sum_code = next_layer.encode(control_sums);
+
+        if(next_sum_code && is_allowed(vertex, i))
+        {
+          transitions[sum_code * dimension + i] = *next_sum_code;
+        }
+
+        --control_sums[i];
+      }
+    }
+
+    incoming_edges.clear();
+
+    for(const Edge& incoming : graph.get_incoming(vertex))
+    {
+      const idx source_slot = slots(incoming.get_source());
+
+      incoming_edges.push_back(Incoming{strides[source_slot],
+                                        source_slot == slots(vertex),
+                                        cost_tables(incoming).data()});
+    }
+
+    next_costs.assign(next_layer.size * num_window_states, inf);
+
+    auto& next_previous_controls = previous_controls[index];
+
+    next_previous_controls.assign(next_costs.size(), 0);
+
+    for(std::size_t sum_code = 0; sum_code < previous_layer.size; ++sum_code)
+    {
+      const std::size_t* sum_transitions = transitions.data() + sum_code * dimension;
+
+      const double* window_costs = current_costs.data() + sum_code * num_window_states;
+
+      for(std::size_t window = 0; window < num_window_states; ++window)
+      {
+        const double cost = window_costs[window];
+
+        if(cost == inf)
+        {
+          continue;
+        }
+
+        ++num_states;
+
+        const idx previous_control = (window / stride) % dimension;
+
+        for(idx i = 0; i < dimension; ++i)
+        {
+          const std::size_t next_sum_code = sum_transitions[i];
+
+          if(next_sum_code == invalid)
+          {
+            continue;
+          }
+
+          double next_cost = cost;
+
+          for(const Incoming& incoming : incoming_edges)
+          {
+            const idx source_control = incoming.same_slot ?
+              previous_control :
+              (window / incoming.stride) % dimension;
+
+            next_cost += incoming.cost_table[source_control * dimension + i];
+          }
+
+          const std::size_t next_window = window + i * stride - previous_control * stride;
+
+          const std::size_t next_state = next_sum_code * num_window_states + next_window;
+
+          if(next_cost < next_costs[next_state])
+          {
+            next_costs[next_state] = next_cost;
+            next_previous_controls[next_state] = previous_control;
+          }
+        }
+      }
+    }
+
+    std::swap(current_costs, next_costs);
+  }
+
+  Log(debug) << "Expanded " << num_states << " states";
+
+  std::size_t best_state = invalid;
+  double best_cost = inf;
+
+  for(std::size_t state = 0; state < current_costs.size(); ++state)
+  {
+    if(current_costs[state] < best_cost)
+    {
+      best_cost = current_costs[state];
+      best_state = state;
+    }
+  }
+
+  if(best_state == invalid)
+  {
+    throw std::invalid_argument("Instance is infeasible");
+  }
+
+  VertexMap<Controls> rounded_controls(graph, Controls(dimension, 0.));
+
+  std::size_t window = best_state % num_window_states;
+  std::vector<idx> control_sums = sum_layers.back().decode(best_state / num_window_states);
+
+  for(idx index = num_vertices; index-- > 0;)
+  {
+    const Vertex vertex = graph.get_vertices()[index];
+    const std::size_t stride = strides[slots(vertex)];
+
+    const idx control = (window / stride) % dimension;
+
+    rounded_controls(vertex).at(control) = 1.;
+
+    if(index == 0)
+    {
+      break;
+    }
+
+    const std::size_t state = sum_layers[index].encode(control_sums).value() * num_window_states + window;
+
+    const idx previous_control = previous_controls[index][state];
+
+    window = window + previous_control * stride - control * stride;
+    --control_sums.at(control);
+  }
+
+  assert(controls_are_integral(graph, rounded_controls));
+  assert(controls_are_convex(graph, rounded_controls));
+  assert(cmp::le(control_distance(graph, fractional_controls, rounded_controls),
+                 upper_bound));
+
+  assert(cmp::eq(costs.evaluate(graph, rounded_controls),
+                 best_cost));
+
+  return rounded_controls;
+}
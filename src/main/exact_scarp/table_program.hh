@@ -0,0 +1,77 @@
+#ifndef TABLE_PROGRAM_HH
+#define TABLE_PROGRAM_HH
+
+#include <optional>
+#include <vector>
+
+#include "controls.hh"
+#include "control_sums.hh"
+#include "cost_function.hh"
+#include "point.hh"
+
+#include "graph/edge_map.hh"
+#include "graph/vertex_map.hh"
+
+/**
+ * An exact solver for grids which are swept row by row (in the
+ * same or in alternating directions). Each vertex is assigned the
+ * slot given by its position within its row. All incoming Edge%s
+ * of a vertex then leave the most recent vertices of their slots,
+ * i.e., the state of the dynamic program consists of the controls
+ * of the most recent vertex of each slot together with the
+ * (feasible) control sums. States are stored in dense arrays,
+ * the costs of all Edge%s and the transitions of the control
+ * sums are tabulated in advance.
+ **/
+class TableProgram
+{
+private:
+  const Graph& graph;
+  const CostFunction& costs;
+  const VertexMap<Controls>& fractional_controls;
+
+  bool vanishing_constraints;
+
+  const Vertex source;
+  const idx dimension;
+  const double upper_bound;
+
+  const VertexMap<idx> slots;
+  idx num_slots;
+
+  std::vector<std::size_t> strides;
+  std::size_t num_window_states;
+
+  EdgeMap<std::vector<double>> cost_tables;
+
+  bool is_allowed(const Vertex& vertex, idx control) const;
+
+public:
+  /**
+   * The maximum number of states per vertex.
+   **/
+  static const std::size_t max_states;
+
+  /**
+   * Constructs a new TableProgram. Throws an std::invalid_argument
+   * if the Graph is not swept row by row with respect to the
+   * given coordinates or if the number of states exceeds
+   * the maximum.
+   **/
+  TableProgram(const Graph& graph,
+               const CostFunction& costs,
+               const VertexMap<Controls>& fractional_controls,
+               const VertexMap<Point>& coordinates,
+               bool vanishing_constraints = false);
+
+  VertexMap<Controls> solve();
+};
+
+/**
+ * Returns the slots of the vertices if the Graph is swept
+ * row by row with respect to the given coordinates.
+ **/
+std::optional<VertexMap<idx>> compute_sweep_slots(const Graph& graph,
+                                                  const VertexMap<Point>& coordinates);
+
+#endif /* TABLE_PROGRAM_HH */
@@ -0,0 +1,365 @@
+#include "local_search.hh"
+
+#include <algorithm>
+
+#include "log.hh"
+#include "timer.hh"
+
+DeviationTree::DeviationTree(const std::vector<double>& values)
+  : size(values.size()),
+    min_values(4 * std::max(size, (idx) 1), 0.),
+    max_values(4 * std::max(size, (idx) 1), 0.),
+    offsets(4 * std::max(size, (idx) 1), 0.)
+{
+  if(size > 0)
+  {
+    build(1, 0, size - 1, values);
+  }
+}
+
+void DeviationTree::build(idx node, idx first, idx last, const std::vector<double>& values)
+{
+  if(first == last)
+  {
+    min_values[node] = values[first];
+    max_values[node] = values[first];
+    return;
+  }
+
+  const idx mid = (first + last) / 2;
+
+  build(2*node, first, mid, values);
+  build(2*node + 1, mid + 1, last, values);
+
+  min_values[node] = std::min(min_values[2*node], min_values[2*node + 1]);
+  max_values[node] = std::max(max_values[2*node], max_values[2*node + 1]);
+}
+
+void DeviationTree::add(idx node, idx first, idx last,
+                        idx range_first, idx range_last, double value)
+{
+  if(range_last < first || last < range_first)
+  {
+    return;
+  }
+
+  if(range_first <= first && last <= range_last)
+  {
+    min_values[node] += value;
+    max_values[node] += value;
+    offsets[node] += value;
+    return;
+  }
+
+  const idx mid = (first + last) / 2;
+
+  add(2*node, first, mid, range_first, range_last, value);
+  add(2*node + 1, mid + 1, last, range_first, range_last, value);
+
+  // offsets apply to the entire subtree and are never pushed down
+  min_values[node] = std::min(min_values[2*node], min_values[2*node + 1]) + offsets[node];
+  max_values[node] = std::max(max_values[2*node], max_values[2*node + 1]) + offsets[node];
+}
+
+double DeviationTree::min(idx node, idx first, idx last,
+                          idx range_first, idx range_last) const
+{
+  if(range_last < first || last < range_first)
+  {
+    return inf;
+  }
+
+  if(range_first <= first && last <= range_last)
+  {
+    return min_values[node];
+  }
+
+  const idx mid = (first + last) / 2;
+
+  return std::min(min(2*node, first, mid, range_first, range_last),
+                  min(2*node + 1, mid + 1, last, range_first, range_last)) + offsets[node];
+}
+
+double DeviationTree::max(idx node, idx first, idx last,
+                          idx range_first, idx range_last) const
+{
+  if(range_last < first || last < range_first)
+  {
+    return -inf;
+  }
+
+  if(range_first <= first && last <= range_last)
+  {
+    return max_values[node];
+  }
+
+  const idx mid = (first + last) / 2;
+
+  return std::max(max(2*node, first, mid, range_first, range_last),
+                  max(2*node + 1, mid + 1, last, range_first, range_last)) + offsets[node];
+}
+
+void DeviationTree::add(idx first, idx last, double value)
+{
+  assert(first <= last && last < size);
+
+  add(1, 0, size - 1, first, last, value);
+}
+
+double DeviationTree::min(idx first, idx last) const
+{
+  assert(first <= last && last < size);
+
+  return min(1, 0, size - 1, first, last);
+}
+
+double DeviationTree::max(idx first, idx last) const
+{
+  assert(first <= last && last < size);
+
+  return max(1, 0, size - 1, first, last);
+}
+
+LocalSearch::LocalSearch(const Graph& graph,
+                         const CostFunction& costs,
+                         const VertexMap<Controls>& fractional_controls,
+                         bool vanishing_constraints,
+                         idx max_passes,
+                         double eps)
+  : graph(graph),
+    costs(costs),
+    fractional_controls(fractional_controls),
+    vanishing_constraints(vanishing_constraints),
+    max_passes(max_passes),
+    eps(eps),
+    source(*graph.get_vertices().begin()),
+    dimension(fractional_controls(source).size()),
+    upper_bound(max_control_deviation(dimension)),
+    num_moves(0)
+{
+  assert(controls_are_convex(graph, fractional_controls));
+}
+
+double LocalSearch::vertex_costs(const Vertex& vertex,
+                                 const VertexMap<Controls>& controls) const
+{
+  double cost = 0.;
+
+  for(const Edge& incoming : graph.get_incoming(vertex))
+  {
+    cost += costs(incoming,
+                  controls(incoming.get_source()),
+                  controls(vertex));
+  }
+
+  for(const Edge& outgoing : graph.get_outgoing(vertex))
+  {
+    cost += costs(outgoing,
+                  controls(vertex),
+                  controls(outgoing.get_target()));
+  }
+
+  return cost;
+}
+
+bool LocalSearch::is_admissible(const Vertex& vertex, idx control) const
+{
+  return !vanishing_constraints ||
+    !cmp::zero(fractional_controls(vertex)[control], eps);
+}
+
+VertexMap<Controls> LocalSearch::improve(const VertexMap<Controls>& initial_controls)
+{
+  assert(controls_are_integral(graph, initial_controls));
+  assert(controls_are_convex(graph, initial_controls));
+
+  Timer timer;
+
+  const idx num_vertices = graph.get_vertices().size();
+
+  num_moves = 0;
+
+  VertexMap<Controls> controls = initial_controls;
+
+  if(num_vertices == 0)
+  {
+    return controls;
+  }
+
+  VertexMap<idx> current_controls(graph, 0);
+
+  for(const Vertex& vertex : graph.get_vertices())
+  {
+    const Controls& vertex_controls = controls(vertex);
+
+    current_controls(vertex) = std::max_element(std::begin(vertex_controls),
+                                                std::end(vertex_controls)) -
+      std::begin(vertex_controls);
+  }
+
+  const double bound = std::max(upper_bound,
+                                control_distance(graph,
+                                                 fractional_controls,
+                                                 controls));
+
+  std::vector<DeviationTree> deviations;
+
+  {
+    std::vector<std::vector<double>> values(dimension, std::vector<double>(num_vertices));
+    std::vector<double> deviation(dimension, 0.);
+
+    for(const Vertex& vertex : graph.get_vertices())
+    {
+      for(idx i = 0; i < dimension; ++i)
+      {
+        deviation[i] += fractional_controls(vertex)[i] - controls(vertex)[i];
+        values[i][vertex.get_index()] = deviation[i];
+      }
+    }
+
+    for(idx i = 0; i < dimension; ++i)
+    {
+      deviations.push_back(DeviationTree(values[i]));
+    }
+  }
+
+  // whether the control of the prefixes in [first, last] can
+  // be changed from the current to the next control
+  auto can_shift = [&](idx current, idx next, idx first, idx last) -> bool
+    {
+      return cmp::le(deviations[current].max(first, last) + 1., bound) &&
+        cmp::ge(deviations[next].min(first, last) - 1., -bound);
+    };
+
+  auto shift = [&](idx current, idx next, idx first, idx last)
+    {
+      deviations[current].add(first, last, 1.);
+      deviations[next].add(first, last, -1.);
+    };
+
+  auto assign = [&](const Vertex& vertex, idx control)
+    {
+      controls(vertex)[current_controls(vertex)] = 0.;
+      controls(vertex)[control] = 1.;
+      current_controls(vertex) = control;
+    };
+
+  const double initial_costs = costs.evaluate(graph, controls);
+
+  idx pass = 0;
+
+  for(; pass < max_passes; ++pass)
+  {
+    const idx previous_moves = num_moves;
+
+    for(const Vertex& vertex : graph.get_vertices())
+    {
+      const idx index = vertex.get_index();
+      const idx current = current_controls(vertex);
+
+      // reassignments
+      {
+        const double current_costs = vertex_costs(vertex, controls);
+
+        double best_costs = current_costs;
+        idx best_control = current;
+
+        for(idx next = 0; next < dimension; ++next)
+        {
+          if(next == current ||
+             !is_admissible(vertex, next) ||
+             !can_shift(current, next, index, num_vertices - 1))
+          {
+            continue;
+          }
+
+          assign(vertex, next);
+
+          const double next_costs = vertex_costs(vertex, controls);
+
+          if(cmp::lt(next_costs, best_costs))
+          {
+            best_costs = next_costs;
+            best_control = next;
+          }
+        }
+
+        assign(vertex, best_control);
+
+        if(best_control != current)
+        {
+          shift(current, best_control, index, num_vertices - 1);
+          ++num_moves;
+        }
+      }
+
+      // swaps
+      for(const Edge& edge : graph.get_outgoing(vertex))
+      {
+        const Vertex other = edge.get_target();
+        const idx other_index = other.get_index();
+
+        const idx first_control = current_controls(vertex);
+        const idx second_control = current_controls(other);
+
+        if(first_control == second_control ||
+           other_index <= index ||
+           !is_admissible(vertex, second_control) ||
+           !is_admissible(other, first_control) ||
+           !can_shift(first_control, second_control, index, other_index - 1))
+        {
+          continue;
+        }
+
+        auto swap_costs = [&]() -> double
+          {
+            return vertex_costs(vertex, controls) +
+              vertex_costs(other, controls) -
+              costs(edge, controls(vertex), controls(other));
+          };
+
+        const double current_costs = swap_costs();
+
+        assign(vertex, second_control);
+        assign(other, first_control);
+
+        if(cmp::lt(swap_costs(), current_costs))
+        {
+          shift(first_control, second_control, index, other_index - 1);
+          ++num_moves;
+        }
+        else
+        {
+          assign(vertex, first_control);
+          assign(other, second_control);
+        }
+      }
+    }
+
+    if(num_moves == previous_moves)
+    {
+      break;
+    }
+  }
+
+  const double final_costs = costs.evaluate(graph, controls);
+
+  Log(info) << "Local search applied "
+            << num_moves
+            << " moves in "
+            << std::min(pass + 1, max_passes)
+            << " passes, reducing the costs from "
+            << initial_costs
+            << " to "
+            << final_costs
+            << " in "
+            << timer.elapsed()
+            << "s";
+
+  assert(controls_are_integral(graph, controls));
+  assert(controls_are_convex(graph, controls));
+  assert(cmp::le(control_distance(graph, fractional_controls, controls), bound));
+  assert(cmp::le(final_costs, initial_costs));
+
+  return controls;
+}
@@ -0,0 +1,117 @@
+#ifndef LOCAL_SEARCH_HH
+#define LOCAL_SEARCH_HH
+
+#include <vector>
+
+#include "cmp.hh"
+#include "controls.hh"
+#include "cost_function.hh"
+#include "graph/graph.hh"
+#include "graph/vertex_map.hh"
+
+/**
+ * A segment tree over the deviations between the fractional and
+ * integral control sums of a single control after each vertex. Supports
+ * adding a value to a range of prefixes and querying the minimum /
+ * maximum deviation of a range in logarithmic time.
+ **/
+class DeviationTree
+{
+private:
+  idx size;
+  std::vector<double> min_values;
+  std::vector<double> max_values;
+  std::vector<double> offsets;
+
+  void build(idx node, idx first, idx last, const std::vector<double>& values);
+
+  void add(idx node, idx first, idx last,
+           idx range_first, idx range_last, double value);
+
+  double min(idx node, idx first, idx last,
+             idx range_first, idx range_last) const;
+
+  double max(idx node, idx first, idx last,
+             idx range_first, idx range_last) const;
+
+public:
+  DeviationTree(const std::vector<double>& values);
+
+  /**
+   * Adds the given value to all deviations in [first, last].
+   **/
+  void add(idx first, idx last, double value);
+
+  /**
+   * Returns the minimum deviation in [first, last].
+   **/
+  double min(idx first, idx last) const;
+
+  /**
+   * Returns the maximum deviation in [first, last].
+   **/
+  double max(idx first, idx last) const;
+};
+
+/**
+ * A local search post-optimizer for integral controls, e.g., obtained
+ * from SUR or SCARP. Applies moves which reduce the costs until no
+ * improving move remains (or the maximum number of passes is reached):
+ *
+ * - Reassigning the control of a single vertex, which shifts the
+ *   deviations of all subsequent prefixes
+ * - Swapping the controls of the endpoints of an Edge, which shifts
+ *   the deviations of the prefixes in between
+ *
+ * The feasibility of each move is checked against the
+ * DeviationTree%s of the affected controls, the change in costs is
+ * computed based on the incident Edge%s only. Each pass therefore
+ * requires near-linear time. Moves never increase the distance
+ * beyond the upper bound (or the distance of the initial controls,
+ * if it is larger).
+ **/
+class LocalSearch
+{
+private:
+  const Graph& graph;
+  const CostFunction& costs;
+  const VertexMap<Controls>& fractional_controls;
+  const bool vanishing_constraints;
+  const idx max_passes;
+  const double eps;
+
+  const Vertex source;
+  const idx dimension;
+  const double upper_bound;
+
+  idx num_moves;
+
+  double vertex_costs(const Vertex& vertex,
+                      const VertexMap<Controls>& controls) const;
+
+  bool is_admissible(const Vertex& vertex, idx control) const;
+
+public:
+  LocalSearch(const Graph& graph,
+              const CostFunction& costs,
+              const VertexMap<Controls>& fractional_controls,
+              bool vanishing_constraints = false,
+              idx max_passes = 10,
+              double eps = cmp::eps);
+
+  /**
+   * Improves the given integral controls, returning
+   * controls whose costs are at most as large.
+   **/
+  VertexMap<Controls> improve(const VertexMap<Controls>& controls);
+
+  /**
+   * Returns the number of moves applied during the last improvement.
+   **/
+  idx get_num_moves() const
+  {
+    return num_moves;
+  }
+};
+
+#endif /* LOCAL_SEARCH_HH */
@@ -0,0 +1,262 @@
+#include "multilevel.hh"
+
+#include <algorithm>
+#include <limits>
+#include <set>
+#include <stdexcept>
+#include <unordered_map>
+
+#include "log.hh"
+#include "timer.hh"
+
+#include "scarp/scarp_program.hh"
+
+CoarseGrid coarsen_grid(const Graph& graph,
+                        const VertexMap<Controls>& fractional_controls,
+                        const VertexMap<Point>& coordinates)
+{
+  const Vertex source = *graph.get_vertices().begin();
+  const idx dimension = fractional_controls(source).size();
+
+  idx min_i = std::numeric_limits<idx>::max();
+  idx min_j = std::numeric_limits<idx>::max();
+
+  for(const Vertex& vertex : graph.get_vertices())
+  {
+    min_i = std::min(min_i, coordinates(vertex).get_i());
+    min_j = std::min(min_j, coordinates(vertex).get_j());
+  }
+
+  std::unordered_map<Point, idx> cell_indices;
+  std::vector<Point> cells;
+
+  VertexMap<Vertex> parents(graph);
+
+  for(const Vertex& vertex : graph.get_vertices())
+  {
+    const Point cell((coordinates(vertex).get_i() - min_i) / 2,
+                     (coordinates(vertex).get_j() - min_j) / 2);
+
+    auto [it, inserted] = cell_indices.insert(std::make_pair(cell, cells.size()));
+
+    if(inserted)
+    {
+      cells.push_back(cell);
+    }
+
+    parents(vertex) = Vertex(it->second);
+  }
+
+  Graph coarse_graph(cells.size());
+
+  std::set<std::pair<idx, idx>> coarse_pairs;
+  std::vector<Edge> edges;
+  std::vector<bool> reversed;
+
+  for(const Edge& edge : graph.get_edges())
+  {
+    const idx first = parents(edge.get_source()).get_index();
+    const idx second = parents(edge.get_target()).get_index();
+
+    if(first == second)
+    {
+      continue;
+    }
+
+    const auto coarse_pair = std::minmax(first, second);
+
+    if(!coarse_pairs.insert(coarse_pair).second)
+    {
+      continue;
+    }
+
+    coarse_graph.add_edge(coarse_graph.get_vertices()[coarse_pair.first],
+                          coarse_graph.get_vertices()[coarse_pair.second]);
+
+    edges.push_back(edge);
+    reversed.push_back(first > second);
+  }
+
+  EdgeMap<Edge> original_edges(coarse_graph);
+  EdgeSet reversed_edges(coarse_graph);
+
+  for(const Edge& edge : coarse_graph.get_edges())
+  {
+    original_edges(edge) = edges[edge.get_index()];
+
+    if(reversed[edge.get_index()])
+    {
+      reversed_edges.insert(edge);
+    }
+  }
+
+  VertexMap<Controls> coarse_controls(coarse_graph, Controls(dimension, 0.));
+  VertexMap<idx> num_cells(coarse_graph, 0);
+
+  for(const Vertex& vertex : graph.get_vertices())
+  {
+    const Vertex parent = parents(vertex);
+
+    for(idx k = 0; k < dimension; ++k)
+    {
+      coarse_controls(parent)[k] += fractional_controls(vertex)[k];
+    }
+
+    ++num_cells(parent);
+  }
+
+  VertexMap<Point> coarse_coordinates(coarse_graph);
+
+  for(const Vertex& vertex : coarse_graph.get_vertices())
+  {
+    for(idx k = 0; k < dimension; ++k)
+    {
+      coarse_controls(vertex)[k] /= (double) num_cells(vertex);
+    }
+
+    coarse_coordinates(vertex) = cells[vertex.get_index()];
+  }
+
+  assert(controls_are_convex(coarse_graph, coarse_controls));
+
+  return CoarseGrid{coarse_graph,
+                    coarse_controls,
+                    coarse_coordinates,
+                    parents,
+                    original_edges,
+                    reversed_edges};
+}
+
+VertexMap<Controls> prolong_controls(const CoarseGrid& coarse_grid,
+                                     const Graph& graph,
+                                     const VertexMap<Controls>& coarse_controls)
+{
+  VertexMap<Controls> controls(graph, {});
+
+  for(const Vertex& vertex : graph.get_vertices())
+  {
+    controls(vertex) = coarse_controls(coarse_grid.parents(vertex));
+  }
+
+  return controls;
+}
+
+MultilevelSCARP::MultilevelSCARP(const Graph& graph,
+                                 const CostFunction& costs,
+                                 const VertexMap<Controls>& fractional_controls,
+                                 const VertexMap<Point>& coordinates,
+                                 idx num_levels,
+                                 idx corridor_width)
+  : graph(graph),
+    costs(costs),
+    fractional_controls(fractional_controls),
+    coordinates(coordinates),
+    num_levels(num_levels),
+    corridor_width(corridor_width),
+    source(*graph.get_vertices().begin()),
+    dimension(fractional_controls(source).size()),
+    num_labels(0),
+    num_widenings(0)
+{
+  assert(controls_are_convex(graph, fractional_controls));
+
+  if(corridor_width == 0)
+  {
+    throw std::invalid_argument("Corridor width must be positive");
+  }
+}
+
+VertexMap<Controls> MultilevelSCARP::solve()
+{
+  Timer timer;
+
+  const idx num_vertices = graph.get_vertices().size();
+
+  num_labels = 0;
+  num_widenings = 0;
+
+  SCARPProgram program(graph, costs, fractional_controls);
+
+  if(num_levels == 0)
+  {
+    auto controls = program.solve();
+
+    num_labels = program.get_num_labels();
+
+    return controls;
+  }
+
+  const CoarseGrid coarse_grid = coarsen_grid(graph,
+                                              fractional_controls,
+                                              coordinates);
+
+  // the grid cannot be coarsened any further
+  if(coarse_grid.graph.get_vertices().size() < 2)
+  {
+    auto controls = program.solve();
+
+    num_labels = program.get_num_labels();
+
+    return controls;
+  }
+
+  MappedCosts coarse_costs(costs,
+                           coarse_grid.original_edges,
+                           coarse_grid.reversed_edges);
+
+  MultilevelSCARP coarse_solver(coarse_grid.graph,
+                                coarse_costs,
+                                coarse_grid.fractional_controls,
+                                coarse_grid.coordinates,
+                                num_levels - 1,
+                                corridor_width);
+
+  const VertexMap<Controls> coarse_controls = coarse_solver.solve();
+
+  num_labels = coarse_solver.get_num_labels();
+  num_widenings = coarse_solver.get_num_widenings();
+
+  const VertexMap<Controls> prolonged_controls = prolong_controls(coarse_grid,
+                                                                  graph,
+                                                                  coarse_controls);
+
+  for(idx width = corridor_width;; width *= 2)
+  {
+    program.set_corridor(prolonged_controls, width);
+
+    try
+    {
+      auto controls = program.solve();
+
+      num_labels += program.get_num_labels();
+
+      Log(info) << "Solved a level with "
+                << num_vertices
+                << " vertices using a corridor of width "
+                << width
+                << ", created "
+                << program.get_num_labels()
+                << " labels in "
+                << timer.elapsed()
+                << "s";
+
+      return controls;
+    }
+    catch(const std::runtime_error&)
+    {
+      num_labels += program.get_num_labels();
+
+      // the corridor does not restrict the labels any more
+      if(width >= num_vertices)
+      {
+        throw;
+      }
+
+      ++num_widenings;
+
+      Log(info) << "No feasible labels within a corridor of width "
+                << width
+                << ", widening";
+    }
+  }
+}
@@ -0,0 +1,117 @@
+#ifndef MULTILEVEL_HH
+#define MULTILEVEL_HH
+
+#include "controls.hh"
+#include "cost_function.hh"
+#include "point.hh"
+#include "graph/graph.hh"
+#include "graph/edge_map.hh"
+#include "graph/edge_set.hh"
+#include "graph/vertex_map.hh"
+
+/**
+ * A coarser grid obtained by aggregating blocks of 2x2 cells of a
+ * finer grid. The coarse vertices are ordered by the first occurrence
+ * of their cells in the order of the fine vertices. As in read_file(),
+ * every Edge is directed from the vertex which comes first to the
+ * other one.
+ **/
+struct CoarseGrid
+{
+  Graph graph;
+
+  // the averages of the fractional controls of the aggregated cells
+  VertexMap<Controls> fractional_controls;
+  VertexMap<Point> coordinates;
+
+  // indexed by the vertices of the fine graph
+  VertexMap<Vertex> parents;
+
+  // indexed by the edges of the coarse graph, an Edge of the
+  // fine graph between the aggregated cells
+  EdgeMap<Edge> original_edges;
+  EdgeSet reversed_edges;
+};
+
+CoarseGrid coarsen_grid(const Graph& graph,
+                        const VertexMap<Controls>& fractional_controls,
+                        const VertexMap<Point>& coordinates);
+
+/**
+ * Prolongs controls from a CoarseGrid, assigning to each fine
+ * vertex the controls of its parent.
+ **/
+VertexMap<Controls> prolong_controls(const CoarseGrid& coarse_grid,
+                                     const Graph& graph,
+                                     const VertexMap<Controls>& coarse_controls);
+
+/**
+ * A multilevel variant of the SCARPProgram: The grid is coarsened a
+ * given number of times, the coarsest grid is solved using the
+ * SCARPProgram. The solution of each level is then prolonged to the
+ * next finer level, where it serves as the center of a corridor
+ * restricting the control sums of the labels (see
+ * SCARPProgram::set_corridor()), which keeps the label fronts small.
+ * If the corridor turns out to be too narrow to contain any feasible
+ * solution, its width is doubled until the level can be solved.
+ *
+ * The corridors can only prune labels if the approximation bound
+ * admits several control sums per control at each vertex and the
+ * prolonged solutions follow the fine ones closely. On the grids
+ * of the dataset (with three controls), the bound admits at most two
+ * sums per control, and any corridor wide enough to be feasible
+ * prunes no labels, such that the coarser levels only add to the
+ * running time. The number of levels therefore defaults to zero,
+ * which solves the SCARPProgram directly.
+ **/
+class MultilevelSCARP
+{
+private:
+  const Graph& graph;
+  const CostFunction& costs;
+  const VertexMap<Controls>& fractional_controls;
+  const VertexMap<Point>& coordinates;
+
+  const idx num_levels;
+  const idx corridor_width;
+
+  const Vertex source;
+  const idx dimension;
+
+  idx num_labels;
+  idx num_widenings;
+
+public:
+  /**
+   * Constructs a new MultilevelSCARP. Throws an std::invalid_argument
+   * if the corridor width is zero.
+   **/
+  MultilevelSCARP(const Graph& graph,
+                  const CostFunction& costs,
+                  const VertexMap<Controls>& fractional_controls,
+                  const VertexMap<Point>& coordinates,
+                  idx num_levels = 0,
+                  idx corridor_width = 3);
+
+  VertexMap<Controls> solve();
+
+  /**
+   * Returns the number of labels created during
+   * the last solve on all levels.
+   **/
+  idx get_num_labels() const
+  {
+    return num_labels;
+  }
+
+  /**
+   * Returns the number of times a corridor was
+   * widened during the last solve on all levels.
+   **/
+  idx get_num_widenings() const
+  {
+    return num_widenings;
+  }
+};
+
+#endif /* MULTILEVEL_HH */
@@ -0,0 +1,312 @@
+#include "neighborhood_search.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+
+#include "cmp.hh"
+#include "dag_program.hh"
+#include "log.hh"
+#include "timer.hh"
+
+#include "graph/vertex_set.hh"
+
+NeighborhoodSearch::NeighborhoodSearch(const Graph& graph,
+                                       const VertexMap<Controls>& fractional_controls,
+                                       const CostFunction& costs,
+                                       idx window_size,
+                                       idx num_threads,
+                                       idx max_rounds)
+  : graph(graph),
+    fractional_controls(fractional_controls),
+    costs(costs),
+    window_size(window_size),
+    num_threads(std::max(num_threads, (idx) 1)),
+    max_rounds(max_rounds)
+{
+  if(window_size == 0)
+  {
+    throw std::invalid_argument("Window size must be positive");
+  }
+}
+
+std::vector<std::vector<Vertex>> NeighborhoodSearch::compute_windows() const
+{
+  const idx num_vertices = graph.get_vertices().size();
+
+  // consecutive windows overlap by half of their size
+  const idx step = std::max(window_size / 2, (idx) 1);
+
+  std::vector<std::vector<Vertex>> windows;
+
+  for(idx start = 0; start < num_vertices; start += step)
+  {
+    const idx end = std::min(start + window_size, num_vertices);
+
+    std::vector<Vertex> window;
+
+    for(idx index = start; index < end; ++index)
+    {
+      window.push_back(graph.get_vertices()[index]);
+    }
+
+    windows.push_back(window);
+
+    if(end == num_vertices)
+    {
+      break;
+    }
+  }
+
+  return windows;
+}
+
+VertexMap<Controls> NeighborhoodSearch::improve_rins(const VertexMap<Controls>& solution) const
+{
+  Timer timer;
+
+  const double cost = costs.evaluate(graph, solution);
+
+  DAGProgram program(graph,
+                     fractional_controls,
+                     costs,
+                     Formulation::CUMULATIVE);
+
+  VertexMap<Controls> relaxed_controls(graph, Controls());
+
+  program.solve_relaxation(relaxed_controls);
+
+  std::vector<Vertex> fixed_vertices;
+
+  for(const Vertex& vertex : graph.get_vertices())
+  {
+    const Controls& controls = solution(vertex);
+    const Controls& relaxed = relaxed_controls(vertex);
+
+    bool agrees = true;
+
+    for(idx i = 0; i < controls.size(); ++i)
+    {
+      if(!cmp::eq(controls[i], relaxed[i]))
+      {
+        agrees = false;
+        break;
+      }
+    }
+
+    if(agrees)
+    {
+      fixed_vertices.push_back(vertex);
+    }
+  }
+
+  Log(info) << "Fixed "
+            << fixed_vertices.size()
+            << " out of "
+            << graph.get_vertices().size()
+            << " vertices in RINS neighborhood";
+
+  program.fix_controls(solution, fixed_vertices);
+  program.set_initial_solution(solution);
+
+  VertexMap<Controls> improved_solution = program.solve();
+
+  const double improved_cost = costs.evaluate(graph, improved_solution);
+
+  Log(info) << "Solved RINS neighborhood in "
+            << timer.elapsed()
+            << "s, costs: "
+            << cost
+            << " -> "
+            << improved_cost;
+
+  if(cmp::lt(improved_cost, cost))
+  {
+    return improved_solution;
+  }
+
+  return solution;
+}
+
+VertexMap<Controls> NeighborhoodSearch::improve_windows(const VertexMap<Controls>& solution) const
+{
+  const std::vector<std::vector<Vertex>> windows = compute_windows();
+
+  const idx num_workers = std::min(num_threads, (idx) windows.size());
+
+  // one program (and environment) per worker, reused across rounds
+  std::vector<std::unique_ptr<DAGProgram>> programs;
+
+  for(idx worker = 0; worker < num_workers; ++worker)
+  {
+    programs.push_back(std::make_unique<DAGProgram>(graph,
+                                                    fractional_controls,
+                                                    costs,
+                                                    Formulation::CUMULATIVE));
+  }
+
+  // vertices outside of each window
+  std::vector<std::vector<Vertex>> fixed_vertices(windows.size());
+
+  for(idx k = 0; k < windows.size(); ++k)
+  {
+    VertexSet window(graph);
+
+    for(const Vertex& vertex : windows[k])
+    {
+      window.insert(vertex);
+    }
+
+    for(const Vertex& vertex : graph.get_vertices())
+    {
+      if(!window.contains(vertex))
+      {
+        fixed_vertices[k].push_back(vertex);
+      }
+    }
+  }
+
+  const Vertex source = *graph.get_vertices().begin();
+  const double upper_bound = max_control_deviation(fractional_controls(source).size());
+
+  VertexMap<Controls> incumbent = solution;
+  double incumbent_cost = costs.evaluate(graph, incumbent);
+
+  for(idx round = 0; round < max_rounds; ++round)
+  {
+    Timer timer;
+
+    std::vector<std::optional<VertexMap<Controls>>> results(windows.size());
+    std::atomic<idx> next_window(0);
+
+    auto solve_windows = [&](DAGProgram& program)
+      {
+        for(idx k = next_window++; k < windows.size(); k = next_window++)
+        {
+          program.release_controls();
+          program.fix_controls(incumbent, fixed_vertices[k]);
+          program.set_initial_solution(incumbent);
+
+          try
+          {
+            results[k] = program.solve();
+          }
+          catch(GRBException& exc)
+          {
+            Log(error) << "Failed to solve window "
+                       << k
+                       << ": "
+                       << exc.getMessage();
+          }
+          catch(const std::runtime_error& exc)
+          {
+            Log(error) << "Failed to solve window "
+                       << k
+                       << ": "
+                       << exc.what();
+          }
+        }
+      };
+
+    std::vector<std::thread> workers;
+
+    for(idx worker = 1; worker < num_workers; ++worker)
+    {
+      workers.emplace_back(solve_windows, std::ref(*programs[worker]));
+    }
+
+    solve_windows(*programs.front());
+
+    for(std::thread& worker : workers)
+    {
+      worker.join();
+    }
+
+    std::vector<std::pair<double, idx>> improving_windows;
+
+    for(idx k = 0; k < windows.size(); ++k)
+    {
+      if(!results[k])
+      {
+        continue;
+      }
+
+      const double cost = costs.evaluate(graph, *results[k]);
+
+      if(cmp::lt(cost, incumbent_cost))
+      {
+        improving_windows.push_back(std::make_pair(cost, k));
+      }
+    }
+
+    std::sort(std::begin(improving_windows),
+              std::end(improving_windows));
+
+    const double previous_cost = incumbent_cost;
+
+    idx num_applied = 0;
+
+    // the windows are solved with respect to the previous incumbent,
+    // combinations of windows have to be checked again
+    for(const auto& [window_cost, k] : improving_windows)
+    {
+      VertexMap<Controls> candidate = incumbent;
+
+      for(const Vertex& vertex : windows[k])
+      {
+        candidate(vertex) = (*results[k])(vertex);
+      }
+
+      const double cost = costs.evaluate(graph, candidate);
+
+      if(!cmp::lt(cost, incumbent_cost))
+      {
+        continue;
+      }
+
+      if(cmp::gt(control_distance(graph, fractional_controls, candidate),
+                 upper_bound))
+      {
+        continue;
+      }
+
+      incumbent = std::move(candidate);
+      incumbent_cost = cost;
+
+      ++num_applied;
+    }
+
+    Log(info) << "Solved "
+              << windows.size()
+              << " windows of size "
+              << window_size
+              << " in round "
+              << round
+              << " in "
+              << timer.elapsed()
+              << "s, applied "
+              << num_applied
+              << " out of "
+              << improving_windows.size()
+              << " improving windows, costs: "
+              << previous_cost
+              << " -> "
+              << incumbent_cost;
+
+    if(num_applied == 0)
+    {
+      break;
+    }
+  }
+
+  return incumbent;
+}
+
+VertexMap<Controls> NeighborhoodSearch::improve(const VertexMap<Controls>& solution) const
+{
+  return improve_windows(improve_rins(solution));
+}
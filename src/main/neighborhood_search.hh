@@ -0,0 +1,72 @@
+#ifndef NEIGHBORHOOD_SEARCH_HH
+#define NEIGHBORHOOD_SEARCH_HH
+
+#include <vector>
+
+#include "controls.hh"
+#include "cost_function.hh"
+#include "graph/graph.hh"
+#include "graph/vertex_map.hh"
+
+/**
+ * Improves a given (feasible) solution, e.g., obtained by a
+ * SCARPProgram or by sum-up rounding, by solving restricted
+ * DAGProgram%s whose controls are fixed to those of the
+ * incumbent on most vertices:
+ *
+ * - In the RINS neighborhood, the controls are fixed on all vertices
+ *   where the incumbent agrees with the LP relaxation.
+ *
+ * - In the window neighborhoods, only the controls of a window of
+ *   consecutive vertices (which are spatially close for the
+ *   usual sweeps through the grid) remain free. Overlapping windows
+ *   are solved in parallel, each worker thread using its own program
+ *   based on an environment borrowed from the EnvironmentPool.
+ *   In each round, the improving windows are applied greedily in
+ *   the order of their improvements as long as the combined solution
+ *   remains feasible and improves further. The rounds are repeated
+ *   until no window yields an improvement. A window whose program
+ *   fails to solve is skipped in the respective round.
+ *
+ * All programs use the cumulative formulation.
+ **/
+class NeighborhoodSearch
+{
+private:
+  const Graph& graph;
+  const VertexMap<Controls>& fractional_controls;
+  const CostFunction& costs;
+
+  const idx window_size;
+  const idx num_threads;
+  const idx max_rounds;
+
+  std::vector<std::vector<Vertex>> compute_windows() const;
+
+public:
+  NeighborhoodSearch(const Graph& graph,
+                     const VertexMap<Controls>& fractional_controls,
+                     const CostFunction& costs,
+                     idx window_size,
+                     idx num_threads = 1,
+                     idx max_rounds = 10);
+
+  /**
+   * Solves the RINS neighborhood of the given solution, returning
+   * the improved solution (or the given one if there is no improvement).
+   **/
+  VertexMap<Controls> improve_rins(const VertexMap<Controls>& solution) const;
+
+  /**
+   * Iterates over the window neighborhoods of the given solution,
+   * returning the improved solution.
+   **/
+  VertexMap<Controls> improve_windows(const VertexMap<Controls>& solution) const;
+
+  /**
+   * Solves the RINS neighborhood, followed by the window neighborhoods.
+   **/
+  VertexMap<Controls> improve(const VertexMap<Controls>& solution) const;
+};
+
+#endif /* NEIGHBORHOOD_SEARCH_HH */
@@ -0,0 +1,280 @@
+#include "portfolio.hh"
+
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+#include "cmp.hh"
+#include "dag_program.hh"
+#include "log.hh"
+#include "timer.hh"
+
+#include "exact_scarp/exact_program.hh"
+#include "scarp/scarp_program.hh"
+#include "sur/sur.hh"
+
+std::ostream& operator<<(std::ostream& out, PortfolioSolver solver)
+{
+  if(solver == PortfolioSolver::SUR)
+  {
+    out << "SUR";
+  }
+  else if(solver == PortfolioSolver::SCARP)
+  {
+    out << "SCARP";
+  }
+  else if(solver == PortfolioSolver::EXACT)
+  {
+    out << "Exact";
+  }
+  else
+  {
+    out << "MIP";
+  }
+
+  return out;
+}
+
+Portfolio::Portfolio(const Graph& graph,
+                     const VertexMap<Controls>& fractional_controls,
+                     const CostFunction& costs,
+                     double time_limit)
+  : graph(graph),
+    fractional_controls(fractional_controls),
+    costs(costs),
+    time_limit(time_limit),
+    finished(false)
+{
+  assert(controls_are_convex(graph, fractional_controls));
+}
+
+void Portfolio::submit(const VertexMap<Controls>& controls,
+                       PortfolioSolver solver,
+                       bool optimal,
+                       DAGProgram& program)
+{
+  const double control_costs = costs.evaluate(graph, controls);
+
+  Log(info) << "Solver "
+            << solver
+            << " found a"
+            << (optimal ? "n optimal" : "")
+            << " solution with costs "
+            << control_costs;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if(best_result && best_result->optimal)
+    {
+      return;
+    }
+
+    const bool improved = !best_result ||
+      cmp::lt(control_costs, best_result->costs);
+
+    if(!(improved || optimal))
+    {
+      return;
+    }
+
+    best_result = PortfolioResult{controls, control_costs, solver, optimal};
+  }
+
+  if(optimal)
+  {
+    finish();
+
+    if(solver != PortfolioSolver::MIP)
+    {
+      program.terminate();
+    }
+  }
+  else if(solver != PortfolioSolver::MIP)
+  {
+    program.suggest_solution(controls);
+  }
+}
+
+void Portfolio::finish()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    finished = true;
+  }
+
+  condition.notify_all();
+}
+
+PortfolioResult Portfolio::solve()
+{
+  Timer timer;
+
+  finished = false;
+  best_result.reset();
+
+  DAGProgram program(graph,
+                     fractional_controls,
+                     costs,
+                     Formulation::CUMULATIVE);
+
+  // suggested solutions are injected by the callback,
+  // SCARP is run separately
+  program.enable_heuristic_callback(false);
+
+  ExactProgram exact_program(graph,
+                             costs,
+                             fractional_controls);
+
+  exact_program.set_interrupt(&finished);
+
+  std::vector<std::thread> threads;
+
+  idx num_running = 0;
+
+  // runs a solver on a separate thread, keeping track
+  // of the number of running solvers
+  auto run = [&](auto solver)
+    {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        ++num_running;
+      }
+
+      threads.emplace_back([&, solver]()
+        {
+          solver();
+
+          {
+            std::lock_guard<std::mutex> lock(mutex);
+            --num_running;
+          }
+
+          condition.notify_all();
+        });
+    };
+
+  run([&]()
+    {
+      submit(compute_sur_controls(graph, fractional_controls, costs),
+             PortfolioSolver::SUR,
+             false,
+             program);
+    });
+
+  run([&]()
+    {
+      SCARPProgram scarp_program(graph,
+                                 costs,
+                                 fractional_controls);
+
+      scarp_program.set_interrupt(&finished);
+
+      try
+      {
+        submit(scarp_program.solve(),
+               PortfolioSolver::SCARP,
+               false,
+               program);
+      }
+      catch(const std::runtime_error&)
+      {
+        Log(info) << "SCARP was cancelled after "
+                  << timer.elapsed()
+                  << "s";
+      }
+    });
+
+  run([&]()
+    {
+      exact_program.set_time_limit(std::max(time_limit - timer.elapsed(), 0.));
+
+      auto exact_controls = exact_program.solve();
+
+      submit(exact_controls,
+             PortfolioSolver::EXACT,
+             exact_program.is_optimal(),
+             program);
+
+      if(exact_program.is_optimal())
+      {
+        Log(info) << "Proved optimality after "
+                  << timer.elapsed()
+                  << "s, cancelling remaining solvers";
+      }
+    });
+
+  try
+  {
+    program.set_time_limit(std::max(time_limit - timer.elapsed(), 0.));
+
+    auto mip_controls = program.solve();
+
+    submit(mip_controls,
+           PortfolioSolver::MIP,
+           program.is_optimal(),
+           program);
+
+    if(program.is_optimal())
+    {
+      Log(info) << "Proved optimality after "
+                << timer.elapsed()
+                << "s, cancelling remaining solvers";
+    }
+  }
+  catch(const std::runtime_error& exc)
+  {
+    // e.g., terminated before finding a solution
+    Log(info) << "MIP did not yield a solution: "
+              << exc.what();
+  }
+  catch(GRBException& exc)
+  {
+    Log(error) << "Caught Gurobi exception: "
+               << exc.getMessage();
+  }
+
+  // the remaining solvers are cancelled once the time limit
+  // expires (e.g., if the MIP failed early)
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+
+    auto done = [&]() -> bool
+      {
+        return finished || num_running == 0;
+      };
+
+    if(time_limit == inf)
+    {
+      condition.wait(lock, done);
+    }
+    else
+    {
+      const double remaining = std::max(time_limit - timer.elapsed(), 0.);
+
+      condition.wait_for(lock,
+                         std::chrono::duration<double>(remaining),
+                         done);
+    }
+  }
+
+  finish();
+
+  for(std::thread& thread : threads)
+  {
+    thread.join();
+  }
+
+  assert(best_result);
+
+  Log(info) << "Best solution found by "
+            << best_result->solver
+            << " with costs "
+            << best_result->costs
+            << " after "
+            << timer.elapsed()
+            << "s";
+
+  return *best_result;
+}
@@ -0,0 +1,87 @@
+#ifndef PORTFOLIO_HH
+#define PORTFOLIO_HH
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <ostream>
+
+#include "controls.hh"
+#include "cost_function.hh"
+#include "graph/graph.hh"
+#include "graph/vertex_map.hh"
+
+/**
+ * @enum PortfolioSolver The solvers run by a Portfolio
+ **/
+enum class PortfolioSolver
+{
+  /** Sum-up rounding **/
+  SUR,
+  /** The SCARPProgram **/
+  SCARP,
+  /** The ExactProgram **/
+  EXACT,
+  /** The DAGProgram **/
+  MIP
+};
+
+std::ostream& operator<<(std::ostream& out, PortfolioSolver solver);
+
+struct PortfolioResult
+{
+  VertexMap<Controls> controls;
+  double costs;
+  PortfolioSolver solver;
+  // whether the controls are proven to be optimal
+  bool optimal;
+};
+
+class DAGProgram;
+
+/**
+ * Runs SUR, the SCARPProgram, the ExactProgram and the DAGProgram
+ * concurrently on separate threads under a common time limit.
+ * Every improved solution is suggested to the running DAGProgram.
+ * As soon as either the ExactProgram or the DAGProgram proves
+ * optimality, or the time limit expires, the remaining solvers
+ * are cancelled cooperatively (the SCARPProgram is interrupted, the
+ * ExactProgram completes its labels with a history length of one).
+ **/
+class Portfolio
+{
+private:
+  const Graph& graph;
+  const VertexMap<Controls>& fractional_controls;
+  const CostFunction& costs;
+
+  const double time_limit;
+
+  std::mutex mutex;
+  std::optional<PortfolioResult> best_result;
+  std::atomic<bool> finished;
+  std::condition_variable condition;
+
+  // cancels the remaining solvers
+  void finish();
+
+  void submit(const VertexMap<Controls>& controls,
+              PortfolioSolver solver,
+              bool optimal,
+              DAGProgram& program);
+
+public:
+  Portfolio(const Graph& graph,
+            const VertexMap<Controls>& fractional_controls,
+            const CostFunction& costs,
+            double time_limit = inf);
+
+  /**
+   * Returns the best solution found by any of the solvers
+   * together with the solver which produced it.
+   **/
+  PortfolioResult solve();
+};
+
+#endif /* PORTFOLIO_HH */
@@ -0,0 +1,201 @@
+#include "reordering.hh"
+
+#include <algorithm>
+#include <set>
+#include <tuple>
+
+std::vector<Vertex> compute_bandwidth_order(const Graph& graph)
+{
+  const idx size = graph.get_vertices().size();
+
+  auto degree = [&](const Vertex& vertex) -> idx
+    {
+      return graph.get_incoming(vertex).size() + graph.get_outgoing(vertex).size();
+    };
+
+  // A Cuthill-McKee order restricted to topological orders: among
+  // the vertices whose predecessors have all been placed, the one
+  // whose first placed neighbor came first is placed next
+  typedef std::tuple<idx, idx, idx> Key;
+
+  std::set<Key> ready;
+
+  VertexMap<idx> num_remaining(graph, 0);
+  VertexMap<idx> first_neighbors(graph, size);
+
+  for(const Vertex& vertex : graph.get_vertices())
+  {
+    num_remaining(vertex) = graph.get_incoming(vertex).size();
+
+    if(num_remaining(vertex) == 0)
+    {
+      ready.insert(std::make_tuple(size, degree(vertex), vertex.get_index()));
+    }
+  }
+
+  std::vector<Vertex> order;
+  order.reserve(size);
+
+  while(!ready.empty())
+  {
+    const Vertex vertex = graph.get_vertices()[std::get<2>(*ready.begin())];
+
+    ready.erase(ready.begin());
+
+    const idx position = order.size();
+
+    order.push_back(vertex);
+
+    for(const Edge& edge : graph.get_outgoing(vertex))
+    {
+      const Vertex target = edge.get_target();
+
+      first_neighbors(target) = std::min(first_neighbors(target), position);
+
+      if(--num_remaining(target) == 0)
+      {
+        ready.insert(std::make_tuple(first_neighbors(target),
+                                     degree(target),
+                                     target.get_index()));
+      }
+    }
+  }
+
+  assert(order.size() == size);
+
+  return order;
+}
+
+Reordering reorder_graph(const Graph& graph,
+                         const std::vector<Vertex>& order)
+{
+  const idx size = graph.get_vertices().size();
+
+  assert(order.size() == size);
+
+  Graph reordered_graph(size);
+
+  VertexMap<Vertex> reordered_vertices(graph);
+  VertexMap<Vertex> original_vertices(graph);
+
+  idx position = 0;
+
+  for(const Vertex& vertex : order)
+  {
+    Vertex reordered_vertex = reordered_graph.get_vertices()[position++];
+
+    reordered_vertices(vertex) = reordered_vertex;
+    original_vertices(reordered_vertex) = vertex;
+  }
+
+  EdgeMap<Edge> original_edges(graph);
+  EdgeSet reversed_edges(graph);
+
+  for(const Edge& edge : graph.get_edges())
+  {
+    const Vertex source = reordered_vertices(edge.get_source());
+    const Vertex target = reordered_vertices(edge.get_target());
+
+    const bool reversed = target < source;
+
+    Edge reordered_edge = reversed ?
+      reordered_graph.add_edge(target, source) :
+      reordered_graph.add_edge(source, target);
+
+    original_edges(reordered_edge) = edge;
+
+    if(reversed)
+    {
+      reversed_edges.insert(reordered_edge);
+    }
+  }
+
+  return Reordering{reordered_graph,
+                    reordered_vertices,
+                    original_vertices,
+                    original_edges,
+                    reversed_edges};
+}
+
+Reordering induce_subgraph(const Graph& graph,
+                           const std::vector<Vertex>& vertices)
+{
+  assert(std::is_sorted(std::begin(vertices), std::end(vertices)));
+
+  Graph subgraph(vertices.size());
+
+  VertexMap<Vertex> reordered_vertices(graph);
+  VertexMap<Vertex> original_vertices(subgraph);
+  VertexSet contained(graph);
+
+  idx position = 0;
+
+  for(const Vertex& vertex : vertices)
+  {
+    Vertex reordered_vertex = subgraph.get_vertices()[position++];
+
+    reordered_vertices(vertex) = reordered_vertex;
+    original_vertices(reordered_vertex) = vertex;
+    contained.insert(vertex);
+  }
+
+  std::vector<Edge> edges;
+
+  for(const Vertex& vertex : vertices)
+  {
+    for(const Edge& edge : graph.get_outgoing(vertex))
+    {
+      if(!contained.contains(edge.get_target()))
+      {
+        continue;
+      }
+
+      subgraph.add_edge(reordered_vertices(edge.get_source()),
+                        reordered_vertices(edge.get_target()));
+
+      edges.push_back(edge);
+    }
+  }
+
+  // the order of the vertices is retained, no edge is reversed
+  EdgeMap<Edge> original_edges(subgraph);
+  EdgeSet reversed_edges(subgraph);
+
+  for(const Edge& edge : subgraph.get_edges())
+  {
+    original_edges(edge) = edges[edge.get_index()];
+  }
+
+  return Reordering{subgraph,
+                    reordered_vertices,
+                    original_vertices,
+                    original_edges,
+                    reversed_edges};
+}
+
+VertexMap<Controls> reorder_controls(const Reordering& reordering,
+                                     const VertexMap<Controls>& controls)
+{
+  VertexMap<Controls> reordered_controls(reordering.graph, {});
+
+  for(const Vertex& vertex : reordering.graph.get_vertices())
+  {
+    reordered_controls(vertex) = controls(reordering.original_vertices(vertex));
+  }
+
+  return reordered_controls;
+}
+
+VertexMap<Controls> restore_controls(const Reordering& reordering,
+                                     const Graph& original_graph,
+                                     const VertexMap<Controls>& controls)
+{
+  VertexMap<Controls> original_controls(original_graph, {});
+
+  for(const Vertex& vertex : original_graph.get_vertices())
+  {
+    original_controls(vertex) = controls(reordering.reordered_vertices(vertex));
+  }
+
+  return original_controls;
+}
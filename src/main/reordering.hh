@@ -0,0 +1,59 @@
+#ifndef REORDERING_HH
+#define REORDERING_HH
+
+#include <vector>
+
+#include "controls.hh"
+#include "util.hh"
+#include "graph/graph.hh"
+#include "graph/edge_map.hh"
+#include "graph/edge_set.hh"
+#include "graph/vertex_map.hh"
+
+/**
+ * A copy of a Graph whose vertices have been renumbered
+ * according to a given order, together with the maps
+ * between the original and the reordered vertices / Edge%s.
+ * As in read_file(), every Edge is directed from the
+ * vertex which comes first in the new order to the other one.
+ **/
+struct Reordering
+{
+  Graph graph;
+
+  // indexed by the vertices of the original graph
+  VertexMap<Vertex> reordered_vertices;
+
+  // indexed by the vertices / edges of the reordered graph
+  VertexMap<Vertex> original_vertices;
+  EdgeMap<Edge> original_edges;
+  EdgeSet reversed_edges;
+};
+
+/**
+ * Computes a topological order of the given DAG with a small
+ * bandwidth using a variant of the Cuthill-McKee algorithm
+ * which only places vertices whose predecessors have
+ * already been placed.
+ **/
+std::vector<Vertex> compute_bandwidth_order(const Graph& graph);
+
+Reordering reorder_graph(const Graph& graph,
+                         const std::vector<Vertex>& order);
+
+/**
+ * Returns the subgraph induced by the given vertices, which are
+ * expected in ascending order and retain their relative order. The
+ * reordered vertices of all other vertices are undefined.
+ **/
+Reordering induce_subgraph(const Graph& graph,
+                           const std::vector<Vertex>& vertices);
+
+VertexMap<Controls> reorder_controls(const Reordering& reordering,
+                                     const VertexMap<Controls>& controls);
+
+VertexMap<Controls> restore_controls(const Reordering& reordering,
+                                     const Graph& original_graph,
+                                     const VertexMap<Controls>& controls);
+
+#endif /* REORDERING_HH */
@@ -1,9 +1,12 @@
 #include "scarp_program.hh"
 
 #include <algorithm>
+#include <cmath>
 #include <sstream>
+#include <stdexcept>
 
 #include "cmp.hh"
+#include "control_sums.hh"
 #include "log.hh"
 #include "graph/vertex_map.hh"
 
@@ -15,11 +18,15 @@ SCARPProgram::SCARPProgram(const Graph& graph,
     costs(costs),
     fractional_controls(fractional_controls),
     vanishing_constraints(vanishing_constraints),
+    interrupt(nullptr),
     source(*graph.get_vertices().begin()),
     dimension(fractional_controls(source).size()),
     upper_bound(max_control_deviation(dimension)),
     labels(graph, LabelFront(dimension, LabelSet())),
     fractional_control_sums(dimension, 0.),
+    num_valid_fronts(0),
+    updated(false),
+    corridor_width(0),
     num_labels(0)
 {
   assert(controls_are_convex(graph, fractional_controls));
@@ -42,6 +49,7 @@ SCARPProgram::get_controls(SCARPLabelPtr label) const
 void SCARPProgram::clear()
 {
   num_labels = 0;
+  num_valid_fronts = 0;
 
   for(idx i = 0; i < dimension; ++i)
   {
@@ -73,12 +81,25 @@ void SCARPProgram::create_initial_labels()
       continue;
     }
 
+    if(!within_corridor(source, std::vector<idx>(dimension, 0), i))
+    {
+      continue;
+    }
+
     labels(source).at(i).insert(std::make_shared<SCARPLabel>(i, source, dimension));
   }
 }
 
 void SCARPProgram::expand(Vertex source, Vertex target)
 {
+  // e.g., if no label remained within the corridor
+  if(std::all_of(std::begin(labels(source)),
+                 std::end(labels(source)),
+                 [](const LabelSet& label_set) { return label_set.empty(); }))
+  {
+    return;
+  }
+
   Controls previous_controls(dimension, 0.);
   Controls next_controls(dimension, 0.);
 
@@ -141,6 +162,11 @@ void SCARPProgram::expand(Vertex source, Vertex target)
           }
         }
 
+        if(!within_corridor(target, label->get_control_sums(), j))
+        {
+          continue;
+        }
+
         next_controls.at(j) = 1.;
 
         double additional_cost = 0.;
@@ -219,23 +245,25 @@ void SCARPProgram::expand(Vertex source, Vertex target)
   }
 }
 
-void SCARPProgram::expand_all()
+bool SCARPProgram::expand_all(idx first)
 {
   auto source_it = graph.get_vertices().begin();
-  auto target_it = graph.get_vertices().begin();
   auto end_it = graph.get_vertices().end();
 
-  ++target_it;
+  std::fill(std::begin(fractional_control_sums),
+            std::end(fractional_control_sums),
+            0.);
 
-  auto add_fractional_controls = [&](Vertex vertex)
-    {
-      for(idx i = 0; i < dimension; ++i)
-      {
-        fractional_control_sums.at(i) += fractional_controls(vertex).at(i);
-      }
-    };
+  for(idx index = 0; index < first; ++index, ++source_it)
+  {
+    add_fractional_controls(*source_it);
+  }
 
-  add_fractional_controls(source);
+  add_fractional_controls(*source_it);
+
+  auto target_it = source_it;
+
+  ++target_it;
 
   for(; target_it != end_it; ++source_it, ++target_it)
   {
@@ -244,6 +272,11 @@ void SCARPProgram::expand_all()
 
     assert(source < target);
 
+    if(interrupt && *interrupt)
+    {
+      return false;
+    }
+
     if(debugging_enabled())
     {
       for(idx i = 0; i < dimension; ++i)
@@ -258,10 +291,85 @@ void SCARPProgram::expand_all()
 
     }
 
+    // discard the labels of a previous solve
+    for(LabelSet& label_set : labels(target))
+    {
+      label_set.clear();
+    }
+
     add_fractional_controls(target);
 
     expand(source, target);
   }
+
+  return true;
+}
+
+bool SCARPProgram::within_corridor(Vertex vertex,
+                                   const std::vector<idx>& control_sums,
+                                   idx control) const
+{
+  if(!corridor_sums)
+  {
+    return true;
+  }
+
+  const std::vector<idx>& center_sums = (*corridor_sums)(vertex);
+
+  for(idx k = 0; k < dimension; ++k)
+  {
+    const idx control_sum = control_sums[k] + (k == control);
+    const idx center_sum = center_sums[k];
+
+    const idx deviation = (control_sum > center_sum) ?
+      (control_sum - center_sum) :
+      (center_sum - control_sum);
+
+    if(deviation > corridor_width)
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void SCARPProgram::set_corridor(const VertexMap<Controls>& controls, idx width)
+{
+  assert(controls_are_integral(graph, controls));
+  assert(controls_are_convex(graph, controls));
+
+  corridor_sums = VertexMap<std::vector<idx>>(graph);
+  corridor_width = width;
+
+  std::vector<idx> control_sums(dimension, 0);
+
+  for(const Vertex& vertex : graph.get_vertices())
+  {
+    for(idx k = 0; k < dimension; ++k)
+    {
+      control_sums[k] += (idx) std::round(controls(vertex).at(k));
+    }
+
+    (*corridor_sums)(vertex) = control_sums;
+  }
+
+  // the labels of a previous solve may lie outside of the corridor
+  num_valid_fronts = 0;
+}
+
+void SCARPProgram::clear_corridor()
+{
+  corridor_sums.reset();
+  num_valid_fronts = 0;
+}
+
+void SCARPProgram::add_fractional_controls(Vertex vertex)
+{
+  for(idx i = 0; i < dimension; ++i)
+  {
+    fractional_control_sums.at(i) += fractional_controls(vertex).at(i);
+  }
 }
 
 double SCARPProgram::get_costs(SCARPLabelPtr label)
@@ -378,11 +486,39 @@ double SCARPProgram::label_distance(SCARPLabelPtr label) const
 
 VertexMap<Controls> SCARPProgram::solve()
 {
-  clear();
+  const idx num_vertices = graph.get_vertices().size();
 
-  create_initial_labels();
+  bool expanded;
+
+  if(!updated || num_valid_fronts == 0)
+  {
+    clear();
+
+    create_initial_labels();
+
+    expanded = expand_all();
+  }
+  else
+  {
+    Log(debug) << "Retaining the labels of "
+               << num_valid_fronts
+               << " out of "
+               << num_vertices
+               << " vertices";
 
-  expand_all();
+    expanded = expand_all(num_valid_fronts - 1);
+  }
+
+  if(!expanded)
+  {
+    // the fronts are only partially expanded
+    num_valid_fronts = 0;
+
+    throw std::runtime_error("Solve was interrupted");
+  }
+
+  num_valid_fronts = num_vertices;
+  updated = false;
 
   SCARPLabelPtr best_label;
 
@@ -401,6 +537,11 @@ VertexMap<Controls> SCARPProgram::solve()
     }
   }
 
+  if(!best_label)
+  {
+    throw std::runtime_error("No feasible labels within the corridor");
+  }
+
   Log(debug) << "Created " << num_labels << " labels";
 
   auto rounded_controls = get_controls(best_label);
@@ -415,3 +556,189 @@ VertexMap<Controls> SCARPProgram::solve()
 
   return rounded_controls;
 }
+
+VertexMap<Controls> SCARPProgram::solve_rolling(idx window)
+{
+  if(window < 2)
+  {
+    throw std::invalid_argument("Window must contain at least two vertices");
+  }
+
+  const idx step = window / 2;
+  const idx num_vertices = graph.get_vertices().size();
+
+  const SumOracle sum_oracle(graph, fractional_controls, upper_bound);
+
+  auto prune_labels = [&](idx index)
+    {
+      for(LabelSet& label_set : labels(graph.get_vertices()[index]))
+      {
+        for(auto it = label_set.begin(); it != label_set.end();)
+        {
+          if(sum_oracle.is_viable(index, (*it)->get_control_sums()))
+          {
+            ++it;
+          }
+          else
+          {
+            it = label_set.erase(it);
+          }
+        }
+      }
+    };
+
+  auto find_best_label = [&](Vertex vertex) -> SCARPLabelPtr
+    {
+      SCARPLabelPtr best_label;
+
+      for(idx i = 0; i < dimension; ++i)
+      {
+        for(const auto& label : labels(vertex).at(i))
+        {
+          if(best_label &&
+             best_label->get_cost() < label->get_cost())
+          {
+            continue;
+          }
+          best_label = label;
+        }
+      }
+
+      if(!best_label)
+      {
+        throw std::runtime_error("No feasible labels remain in the window");
+      }
+
+      return best_label;
+    };
+
+  // the ancestor of the given label at the vertex with the given index
+  auto get_ancestor = [](SCARPLabelPtr label, idx index) -> SCARPLabelPtr
+    {
+      while(label->get_vertex().get_index() > index)
+      {
+        label = label->get_predecessor();
+      }
+
+      return label;
+    };
+
+  clear();
+
+  create_initial_labels();
+
+  add_fractional_controls(source);
+
+  prune_labels(0);
+
+  // the index of the last vertex whose labels have been expanded
+  idx last = 0;
+
+  // the number of vertices whose controls have been committed
+  idx committed = 0;
+
+  while(true)
+  {
+    const idx window_end = std::min(committed + window, num_vertices);
+
+    for(; last + 1 < window_end; ++last)
+    {
+      if(interrupt && *interrupt)
+      {
+        // the labels of previous vertices have been released
+        num_valid_fronts = 0;
+
+        throw std::runtime_error("Solve was interrupted");
+      }
+
+      const Vertex current = graph.get_vertices()[last];
+      const Vertex next = graph.get_vertices()[last + 1];
+
+      add_fractional_controls(next);
+
+      expand(current, next);
+
+      prune_labels(last + 1);
+
+      // the labels of the next vertex retain their predecessors
+      for(LabelSet& label_set : labels(current))
+      {
+        label_set.clear();
+      }
+    }
+
+    const Vertex last_vertex = graph.get_vertices()[last];
+
+    if(last + 1 == num_vertices)
+    {
+      break;
+    }
+
+    committed += step;
+
+    const SCARPLabelPtr anchor = get_ancestor(find_best_label(last_vertex),
+                                              committed - 1);
+
+    for(LabelSet& label_set : labels(last_vertex))
+    {
+      for(auto it = label_set.begin(); it != label_set.end();)
+      {
+        if(get_ancestor(*it, committed - 1) == anchor)
+        {
+          ++it;
+        }
+        else
+        {
+          it = label_set.erase(it);
+        }
+      }
+    }
+  }
+
+  // the labels of previous vertices have been released
+  num_valid_fronts = 0;
+
+  const SCARPLabelPtr best_label = find_best_label(graph.get_vertices()[num_vertices - 1]);
+
+  Log(debug) << "Created " << num_labels << " labels";
+
+  auto rounded_controls = get_controls(best_label);
+
+  assert(controls_are_integral(graph, rounded_controls));
+  assert(controls_are_convex(graph, rounded_controls));
+  assert(cmp::le(control_distance(graph, fractional_controls, rounded_controls),
+                 upper_bound));
+
+  assert(cmp::eq(costs.evaluate(graph, rounded_controls),
+                 best_label->get_cost()));
+
+  return rounded_controls;
+}
+
+void SCARPProgram::update_fractional_controls(const VertexMap<Controls>& fractional_controls)
+{
+  assert(controls_are_convex(graph, fractional_controls));
+  assert(fractional_controls(source).size() == dimension);
+
+  idx index = 0;
+
+  for(const Vertex& vertex : graph.get_vertices())
+  {
+    if(index >= num_valid_fronts)
+    {
+      break;
+    }
+
+    if(fractional_controls(vertex) != this->fractional_controls(vertex))
+    {
+      num_valid_fronts = index;
+      break;
+    }
+
+    ++index;
+  }
+
+  this->fractional_controls = fractional_controls;
+
+  updated = true;
+}
@@ -1,7 +1,9 @@
 #ifndef SCARP_PROGRAM_HH
 #define SCARP_PROGRAM_HH
 
+#include <atomic>
 #include <memory>
+#include <optional>
 
 #include <set>
 #include <unordered_set>
@@ -23,10 +25,13 @@ public:
 private:
   const Graph& graph;
   const CostFunction& costs;
-  const VertexMap<Controls>& fractional_controls;
+  // copied, since the controls may be updated later on
+  VertexMap<Controls> fractional_controls;
 
   bool vanishing_constraints;
 
+  const std::atomic<bool>* interrupt;
+
   const Vertex source;
   const idx dimension;
   const double upper_bound;
@@ -35,13 +40,31 @@ private:
 
   std::vector<double> fractional_control_sums;
 
+  // the number of leading vertices whose labels are
+  // retained from the previous solve
+  idx num_valid_fronts;
+
+  // whether the fractional controls were updated since the previous solve
+  bool updated;
+
+  // the control sums of the center of the corridor after each vertex
+  std::optional<VertexMap<std::vector<idx>>> corridor_sums;
+  idx corridor_width;
+
+  bool within_corridor(Vertex vertex,
+                       const std::vector<idx>& control_sums,
+                       idx control) const;
+
   void clear();
 
   void create_initial_labels();
 
   void expand(Vertex source, Vertex target);
 
-  void expand_all();
+  // returns false if the expansion was interrupted
+  bool expand_all(idx first = 0);
+
+  void add_fractional_controls(Vertex vertex);
 
   double get_costs(SCARPLabelPtr label);
 
@@ -59,7 +82,63 @@ public:
                const VertexMap<Controls>& fractional_controls,
                bool vanishing_constraints = false);
 
+  /**
+   * Sets a flag which may be raised from another thread while
+   * solve() is running, which then throws an std::runtime_error.
+   **/
+  void set_interrupt(const std::atomic<bool>* interrupt)
+  {
+    this->interrupt = interrupt;
+  }
+
+  /**
+   * Solves the program. If the fractional controls were updated
+   * since a previous solve, the expansion is restarted from the
+   * first vertex whose fractional controls were changed.
+   **/
   VertexMap<Controls> solve();
+
+  /**
+   * Restricts the labels of each vertex to control sums which deviate
+   * by at most the given width from the control sums of the given
+   * (integral) controls, e.g., a solution prolonged from a coarser
+   * grid. If no label remains feasible, solve() throws an
+   * std::runtime_error.
+   **/
+  void set_corridor(const VertexMap<Controls>& controls, idx width);
+
+  void clear_corridor();
+
+  /**
+   * Returns the number of labels created during the last solve.
+   **/
+  idx get_num_labels() const
+  {
+    return num_labels;
+  }
+
+  /**
+   * Updates the fractional controls (on the same Graph). The labels
+   * of the vertices preceding the first changed vertex are unaffected
+   * and retained for the next call of solve().
+   **/
+  void update_fractional_controls(const VertexMap<Controls>& fractional_controls);
+
+  /**
+   * Solves the program in a rolling horizon: The labels are expanded
+   * over a window of the given number of vertices. The decisions
+   * for the first half of the window are then committed based on the
+   * path of the best label, the labels whose paths deviate from the
+   * committed prefix are discarded, and the window is moved forward.
+   * The labels of previous vertices are released, so the time
+   * and memory per vertex are independent of the number of vertices.
+   * Labels whose control sums are not viable with respect to a
+   * SumOracle are pruned to ensure that the window can always be
+   * moved forward. Throws an std::invalid_argument if the window
+   * contains less than two vertices and an std::runtime_error if
+   * the solve is interrupted.
+   **/
+  VertexMap<Controls> solve_rolling(idx window);
 };
 
 
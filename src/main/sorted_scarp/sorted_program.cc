@@ -0,0 +1,323 @@
+#include "sorted_program.hh"
+
+#include <array>
+#include <limits>
+#include <stdexcept>
+
+#include "cmp.hh"
+#include "log.hh"
+
+SortedProgram::SortedProgram(const Graph& graph,
+                             const CostFunction& costs,
+                             const VertexMap<Controls>& fractional_controls,
+                             bool vanishing_constraints,
+                             idx history_length)
+  : graph(graph),
+    costs(costs),
+    fractional_controls(fractional_controls),
+    vanishing_constraints(vanishing_constraints),
+    prefix_map(get_prefix_map(graph, history_length)),
+    source(*graph.get_vertices().begin()),
+    dimension(fractional_controls(source).size()),
+    upper_bound(max_control_deviation(dimension)),
+    cost_tables(tabulate_costs(graph, costs, dimension)),
+    num_labels(0)
+{
+  assert(controls_are_convex(graph, fractional_controls));
+}
+
+void SortedProgram::sort_candidates(std::uint64_t max_key)
+{
+  const idx num_bits = 8;
+  const idx num_buckets = 1 << num_bits;
+
+  buffer.resize(candidates.size());
+
+  std::array<std::size_t, num_buckets> offsets;
+
+  for(idx shift = 0; shift < 64 && (max_key >> shift) != 0; shift += num_bits)
+  {
+    offsets.fill(0);
+
+    for(const Label& label : candidates)
+    {
+      ++offsets[(label.key >> shift) & (num_buckets - 1)];
+    }
+
+    // all keys agree on the current digit
+    if(offsets[(candidates.front().key >> shift) & (num_buckets - 1)] == candidates.size())
+    {
+      continue;
+    }
+
+    std::size_t offset = 0;
+
+    for(auto& bucket_offset : offsets)
+    {
+      const std::size_t bucket_size = bucket_offset;
+      bucket_offset = offset;
+      offset += bucket_size;
+    }
+
+    for(const Label& label : candidates)
+    {
+      buffer[offsets[(label.key >> shift) & (num_buckets - 1)]++] = label;
+    }
+
+    std::swap(candidates, buffer);
+  }
+}
+
+void SortedProgram::reduce_candidates(Layer& layer) const
+{
+  layer.clear();
+
+  for(const Label& label : candidates)
+  {
+    if(!layer.empty() && layer.back().key == label.key)
+    {
+      if(label.cost < layer.back().cost)
+      {
+        layer.back() = label;
+      }
+
+      continue;
+    }
+
+    layer.push_back(label);
+  }
+}
+
+idx SortedProgram::get_control(idx index, idx label, idx vertex_index) const
+{
+  assert(vertex_index <= index);
+
+  for(; index > vertex_index; --index)
+  {
+    label = layers[index][label].predecessor;
+  }
+
+  return layers[index][label].control;
+}
+
+VertexMap<Controls> SortedProgram::get_controls(idx label) const
+{
+  VertexMap<Controls> controls(graph, Controls(dimension, 0.));
+
+  for(idx index = layers.size(); index-- > 0;)
+  {
+    const Label& current = layers[index][label];
+
+    controls(graph.get_vertices()[index]).at(current.control) = 1.;
+
+    label = current.predecessor;
+  }
+
+  return controls;
+}
+
+VertexMap<Controls> SortedProgram::solve()
+{
+  const idx num_vertices = graph.get_vertices().size();
+
+  const std::vector<SumLayer> sum_layers = compute_sum_layers(graph,
+                                                              fractional_controls,
+                                                              upper_bound);
+
+  const std::uint64_t max_key = std::numeric_limits<std::uint64_t>::max();
+
+  // The powers of the dimension up to the maximum prefix length
+  std::vector<std::uint64_t> powers{1};
+
+  // The number of distinct prefixes for each vertex
+  std::vector<std::uint64_t> window_sizes;
+
+  for(const Vertex& vertex : graph.get_vertices())
+  {
+    const idx window_length = prefix_map(vertex);
+
+    while(powers.size() <= window_length)
+    {
+      if(powers.back() > max_key / dimension)
+      {
+        throw std::invalid_argument("Labels do not fit into keys");
+      }
+
+      powers.push_back(powers.back() * dimension);
+    }
+
+    const std::uint64_t window_size = powers[window_length];
+
+    if(sum_layers[vertex.get_index()].size > max_key / window_size)
+    {
+      throw std::invalid_argument("Labels do not fit into keys");
+    }
+
+    window_sizes.push_back(window_size);
+  }
+
+  auto is_allowed = [&](const Vertex& vertex, idx control) -> bool
+    {
+      return !(vanishing_constraints && cmp::zero(fractional_controls(vertex).at(control)));
+    };
+
+  layers.assign(num_vertices, Layer());
+  num_labels = 0;
+
+  {
+    std::vector<idx> control_sums(dimension, 0);
+
+    for(idx i = 0; i < dimension; ++i)
+    {
+      control_sums.at(i) = 1;
+
+      auto sum_code = sum_layers.front().encode(control_sums);
+
+      if(is_allowed(source, i) && sum_code)
+      {
+        layers.front().push_back(Label{(*sum_code) * window_sizes.front() + (i % window_sizes.front()),
+                                       0.,
+                                       0,
+                                       i});
+        ++num_labels;
+      }
+
+      control_sums.at(i) = 0;
+    }
+  }
+
+  const std::size_t invalid = std::numeric_limits<std::size_t>::max();
+
+  std::vector<std::size_t> transitions;
+
+  struct Incoming
+  {
+    idx offset;
+    idx source_index;
+    const double* cost_table;
+  };
+
+  std::vector<Incoming> incoming_edges;
+
+  for(idx index = 1; index < num_vertices; ++index)
+  {
+    const Vertex vertex = graph.get_vertices()[index];
+
+    const SumLayer& previous_layer = sum_layers[index - 1];
+    const SumLayer& next_layer = sum_layers[index];
+
+    const std::uint64_t previous_window_size = window_sizes[index - 1];
+    const std::uint64_t next_window_size = window_sizes[index];
+
+    const idx previous_window_length = prefix_map(graph.get_vertices()[index - 1]);
+
+    transitions.assign(previous_layer.size * dimension, invalid);
+
+    for(std::size_t sum_code = 0; sum_code < previous_layer.size; ++sum_code)
+    {
+      std::vector<idx> control_sums = previous_layer.decode(sum_code);
+
+      for(idx i = 0; i < dimension; ++i)
+      {
+        ++control_sums[i];
+
+        auto next_sum_code = next_layer.encode(control_sums);
+
+        if(next_sum_code && is_allowed(vertex, i))
+        {
+          transitions[sum_code * dimension + i] = *next_sum_code;
+        }
+
+        --control_sums[i];
+      }
+    }
+
+    incoming_edges.clear();
+
+    for(const Edge& incoming : graph.get_incoming(vertex))
+    {
+      const idx source_index = incoming.get_source().get_index();
+
+      incoming_edges.push_back(Incoming{index - source_index,
+                                        source_index,
+                                        cost_tables(incoming).data()});
+    }
+
+    candidates.clear();
+
+    const Layer& previous_labels = layers[index - 1];
+
+    for(idx label_index = 0; label_index < previous_labels.size(); ++label_index)
+    {
+      const Label& label = previous_labels[label_index];
+
+      const std::size_t sum_code = label.key / previous_window_size;
+      const std::uint64_t window = label.key % previous_window_size;
+
+      for(idx i = 0; i < dimension; ++i)
+      {
+        const std::size_t next_sum_code = transitions[sum_code * dimension + i];
+
+        if(next_sum_code == invalid)
+        {
+          continue;
+        }
+
+        double cost = label.cost;
+
+        for(const Incoming& incoming : incoming_edges)
+        {
+          const idx source_control = (incoming.offset <= previous_window_length) ?
+            (window / powers[incoming.offset - 1]) % dimension :
+            get_control(index - 1, label_index, incoming.source_index);
+
+          cost += incoming.cost_table[source_control * dimension + i];
+        }
+
+        const std::uint64_t next_window = (window % (next_window_size / dimension)) * dimension + i;
+
+        candidates.push_back(Label{next_sum_code * next_window_size + next_window,
+                                   cost,
+                                   label_index,
+                                   i});
+      }
+    }
+
+    if(candidates.empty())
+    {
+      throw std::invalid_argument("Instance is infeasible");
+    }
+
+    sort_candidates((next_layer.size - 1) * next_window_size + (next_window_size - 1));
+
+    reduce_candidates(layers[index]);
+
+    num_labels += layers[index].size();
+  }
+
+  Log(debug) << "Created " << num_labels << " labels";
+
+  const Layer& final_labels = layers.back();
+
+  idx best_label = 0;
+
+  for(idx label_index = 1; label_index < final_labels.size(); ++label_index)
+  {
+    if(final_labels[label_index].cost < final_labels[best_label].cost)
+    {
+      best_label = label_index;
+    }
+  }
+
+  auto rounded_controls = get_controls(best_label);
+
+  assert(controls_are_integral(graph, rounded_controls));
+  assert(controls_are_convex(graph, rounded_controls));
+  assert(cmp::le(control_distance(graph, fractional_controls, rounded_controls),
+                 upper_bound));
+
+  assert(cmp::eq(costs.evaluate(graph, rounded_controls),
+                 final_labels[best_label].cost));
+
+  return rounded_controls;
+}
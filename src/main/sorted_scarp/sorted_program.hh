@@ -0,0 +1,84 @@
+#ifndef SORTED_PROGRAM_HH
+#define SORTED_PROGRAM_HH
+
+#include <cstdint>
+#include <vector>
+
+#include "controls.hh"
+#include "control_sums.hh"
+#include "cost_function.hh"
+
+#include "exact_scarp/exact_program.hh"
+
+#include "graph/edge_map.hh"
+#include "graph/vertex_map.hh"
+
+/**
+ * A labeling algorithm storing labels consisting of the control
+ * sums and the controls of the most recent vertices, bounded by
+ * a given history length (a history length of one yields the
+ * labels of the SCARPProgram). Instead of deduplicating labels
+ * in hash sets, all candidate labels of a vertex are appended to a
+ * flat buffer, radix-sorted by their packed keys (consisting of the
+ * control sums and the controls stored in the prefix) and reduced
+ * to the cheapest label per key in a single linear pass. Labels
+ * are therefore processed in a deterministic order, ties
+ * are broken in favor of the first candidate.
+ **/
+class SortedProgram
+{
+private:
+  struct Label
+  {
+    std::uint64_t key;
+    double cost;
+    idx predecessor;
+    idx control;
+  };
+
+  typedef std::vector<Label> Layer;
+
+  const Graph& graph;
+  const CostFunction& costs;
+  const VertexMap<Controls>& fractional_controls;
+
+  bool vanishing_constraints;
+
+  const VertexMap<idx> prefix_map;
+
+  const Vertex source;
+  const idx dimension;
+  const double upper_bound;
+
+  const EdgeMap<std::vector<double>> cost_tables;
+
+  std::vector<Layer> layers;
+
+  Layer candidates;
+  Layer buffer;
+
+  idx num_labels;
+
+  void sort_candidates(std::uint64_t max_key);
+
+  void reduce_candidates(Layer& layer) const;
+
+  idx get_control(idx index, idx label, idx vertex_index) const;
+
+  VertexMap<Controls> get_controls(idx label) const;
+
+public:
+  /**
+   * Constructs a new SortedProgram. Throws an std::invalid_argument if
+   * the labels do not fit into 64-bit keys.
+   **/
+  SortedProgram(const Graph& graph,
+                const CostFunction& costs,
+                const VertexMap<Controls>& fractional_controls,
+                bool vanishing_constraints = false,
+                idx history_length = ExactProgram::unbounded_history);
+
+  VertexMap<Controls> solve();
+};
+
+#endif /* SORTED_PROGRAM_HH */
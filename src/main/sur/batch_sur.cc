@@ -0,0 +1,198 @@
+#include "batch_sur.hh"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+#include "log.hh"
+
+BatchSUR::BatchSUR(idx dimension, idx block_size)
+  : dimension(dimension),
+    block_size(block_size)
+{
+  if(dimension == 0 ||
+     dimension > std::numeric_limits<std::uint8_t>::max())
+  {
+    throw std::invalid_argument("Invalid dimension");
+  }
+
+  if(block_size == 0)
+  {
+    throw std::invalid_argument("Block size must be positive");
+  }
+}
+
+idx BatchSUR::add(const Graph& graph,
+                  const VertexMap<Controls>& fractional_controls)
+{
+  assert(controls_are_convex(graph, fractional_controls));
+
+  std::vector<double> values;
+
+  values.reserve(graph.get_vertices().size() * dimension);
+
+  for(const Vertex& vertex : graph.get_vertices())
+  {
+    const Controls& controls = fractional_controls(vertex);
+
+    if(controls.size() != dimension)
+    {
+      throw std::invalid_argument("Dimension does not match");
+    }
+
+    values.insert(std::end(values), std::begin(controls), std::end(controls));
+  }
+
+  instances.push_back(std::move(values));
+
+  return instances.size() - 1;
+}
+
+void BatchSUR::solve_block(idx first,
+                           std::vector<std::vector<std::uint8_t>>& controls) const
+{
+  const idx last = std::min(first + block_size, (idx) instances.size());
+
+  idx num_vertices = 0;
+
+  for(idx instance = first; instance < last; ++instance)
+  {
+    num_vertices = std::max(num_vertices, (idx) (instances[instance].size() / dimension));
+  }
+
+  const idx stride = dimension * block_size;
+
+  // padded lanes / vertices choose the first control
+  std::vector<double> values(num_vertices * stride, 0.);
+
+  for(idx k = 0; k < num_vertices; ++k)
+  {
+    for(idx lane = 0; lane < block_size; ++lane)
+    {
+      values[k * stride + lane] = 1.;
+    }
+  }
+
+  for(idx instance = first; instance < last; ++instance)
+  {
+    const idx lane = instance - first;
+    const std::vector<double>& instance_values = instances[instance];
+
+    for(idx k = 0; k < instance_values.size() / dimension; ++k)
+    {
+      for(idx i = 0; i < dimension; ++i)
+      {
+        values[k * stride + i * block_size + lane] = instance_values[k * dimension + i];
+      }
+    }
+  }
+
+  std::vector<double> fractional_control_sums(stride, 0.);
+  std::vector<double> control_sums(stride, 0.);
+
+  std::vector<double> deviations(stride);
+
+  std::vector<double> best_deviations(block_size);
+  std::vector<double> best_controls(block_size);
+
+  // the loops over the lanes are vectorized
+  for(idx k = 0; k < num_vertices; ++k)
+  {
+    const double* vertex_values = values.data() + k * stride;
+
+    for(idx j = 0; j < stride; ++j)
+    {
+      fractional_control_sums[j] += vertex_values[j];
+      deviations[j] = fractional_control_sums[j] - control_sums[j];
+    }
+
+    std::fill(std::begin(best_deviations), std::end(best_deviations), -inf);
+    std::fill(std::begin(best_controls), std::end(best_controls), inf);
+
+    for(idx i = 0; i < dimension; ++i)
+    {
+      const double* control_deviations = deviations.data() + i * block_size;
+
+      for(idx lane = 0; lane < block_size; ++lane)
+      {
+        best_deviations[lane] = std::max(best_deviations[lane], control_deviations[lane]);
+      }
+    }
+
+    // the first control with the maximum deviation, as in compute_sur_controls()
+    for(idx i = 0; i < dimension; ++i)
+    {
+      const double* control_deviations = deviations.data() + i * block_size;
+      const double control = (double) i;
+
+      for(idx lane = 0; lane < block_size; ++lane)
+      {
+        const double candidate = (control_deviations[lane] == best_deviations[lane]) ? control : inf;
+
+        best_controls[lane] = std::min(best_controls[lane], candidate);
+      }
+    }
+
+    for(idx i = 0; i < dimension; ++i)
+    {
+      double* sums = control_sums.data() + i * block_size;
+      const double control = (double) i;
+
+      for(idx lane = 0; lane < block_size; ++lane)
+      {
+        sums[lane] += (best_controls[lane] == control) ? 1. : 0.;
+      }
+    }
+
+    for(idx instance = first; instance < last; ++instance)
+    {
+      std::vector<std::uint8_t>& instance_controls = controls[instance];
+
+      if(k < instance_controls.size())
+      {
+        instance_controls[k] = (std::uint8_t) best_controls[instance - first];
+      }
+    }
+  }
+}
+
+std::vector<std::vector<std::uint8_t>> BatchSUR::solve() const
+{
+  std::vector<std::vector<std::uint8_t>> controls;
+
+  controls.reserve(instances.size());
+
+  for(const std::vector<double>& instance_values : instances)
+  {
+    controls.push_back(std::vector<std::uint8_t>(instance_values.size() / dimension, 0));
+  }
+
+  for(idx first = 0; first < instances.size(); first += block_size)
+  {
+    solve_block(first, controls);
+  }
+
+  Log(debug) << "Computed SUR controls for "
+             << instances.size()
+             << " instances";
+
+  return controls;
+}
+
+VertexMap<Controls> expand_controls(const Graph& graph,
+                                    const std::vector<std::uint8_t>& control_indices,
+                                    idx dimension)
+{
+  assert(control_indices.size() == graph.get_vertices().size());
+
+  VertexMap<Controls> controls(graph, Controls(dimension, 0.));
+
+  idx k = 0;
+
+  for(const Vertex& vertex : graph.get_vertices())
+  {
+    controls(vertex).at(control_indices[k++]) = 1.;
+  }
+
+  return controls;
+}
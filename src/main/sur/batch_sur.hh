@@ -0,0 +1,74 @@
+#ifndef BATCH_SUR_HH
+#define BATCH_SUR_HH
+
+#include <cstdint>
+#include <vector>
+
+#include "controls.hh"
+#include "graph/graph.hh"
+#include "graph/vertex_map.hh"
+
+/**
+ * Computes the SUR controls of many (small) instances with the same
+ * dimension at once. The instances are processed in blocks: The
+ * fractional controls of a block are laid out as a structure of arrays,
+ * i.e., the values of all instances of the block for a given vertex
+ * and control are stored contiguously. The rounding is written as
+ * branch-free loops over the instances of a block, which the compiler
+ * vectorizes: The maximum deviation is determined first, then the
+ * first control attaining it. The results coincide with
+ * compute_sur_controls() (without vanishing constraints).
+ **/
+class BatchSUR
+{
+private:
+  const idx dimension;
+  const idx block_size;
+
+  // the fractional controls of each instance, stored row by row
+  std::vector<std::vector<double>> instances;
+
+  void solve_block(idx first,
+                   std::vector<std::vector<std::uint8_t>>& controls) const;
+
+public:
+  /**
+   * Constructs a new BatchSUR rounding the given number of
+   * instances simultaneously. Throws an std::invalid_argument
+   * if the dimension is too large to be stored compactly.
+   **/
+  BatchSUR(idx dimension, idx block_size = 16);
+
+  idx get_block_size() const
+  {
+    return block_size;
+  }
+
+  /**
+   * Adds an instance, returning its index. Throws an
+   * std::invalid_argument if the dimension does not match.
+   **/
+  idx add(const Graph& graph,
+          const VertexMap<Controls>& fractional_controls);
+
+  idx get_num_instances() const
+  {
+    return instances.size();
+  }
+
+  /**
+   * Returns for each instance the index of the
+   * control chosen for each of its vertices.
+   **/
+  std::vector<std::vector<std::uint8_t>> solve() const;
+};
+
+/**
+ * Converts the control indices returned by BatchSUR::solve()
+ * into (integral) controls.
+ **/
+VertexMap<Controls> expand_controls(const Graph& graph,
+                                    const std::vector<std::uint8_t>& control_indices,
+                                    idx dimension);
+
+#endif /* BATCH_SUR_HH */
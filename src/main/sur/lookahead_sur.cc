@@ -0,0 +1,152 @@
+#include "lookahead_sur.hh"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+#include "cmp.hh"
+#include "log.hh"
+#include "timer.hh"
+
+LookaheadSUR::LookaheadSUR(const Graph& graph,
+                           const CostFunction& costs,
+                           const VertexMap<Controls>& fractional_controls,
+                           idx window)
+  : graph(graph),
+    costs(costs),
+    fractional_controls(fractional_controls),
+    window(window),
+    source(*graph.get_vertices().begin()),
+    dimension(fractional_controls(source).size()),
+    upper_bound(max_control_deviation(dimension)),
+    sum_oracle(graph, fractional_controls, upper_bound),
+    controls(graph, Controls(dimension, 0.)),
+    control_sums(dimension, 0),
+    orders(window, std::vector<idx>(dimension)),
+    best_cost(inf),
+    best_control(0)
+{
+  assert(controls_are_convex(graph, fractional_controls));
+
+  if(window == 0)
+  {
+    throw std::invalid_argument("Window must not be empty");
+  }
+
+  Controls sums(dimension, 0.);
+
+  for(const Vertex& vertex : graph.get_vertices())
+  {
+    for(idx i = 0; i < dimension; ++i)
+    {
+      sums[i] += fractional_controls(vertex)[i];
+    }
+
+    fractional_control_sums.push_back(sums);
+  }
+}
+
+void LookaheadSUR::search(idx first, idx index, idx first_control, double cost)
+{
+  const idx num_vertices = graph.get_vertices().size();
+
+  if(index == std::min(first + window, num_vertices))
+  {
+    best_cost = cost;
+    best_control = first_control;
+    return;
+  }
+
+  const Vertex vertex = graph.get_vertices()[index];
+  const Controls& fractional_sums = fractional_control_sums[index];
+
+  std::vector<idx>& order = orders[index - first];
+
+  std::iota(std::begin(order), std::end(order), 0);
+
+  // prefer the controls with the largest deviations
+  std::stable_sort(std::begin(order), std::end(order),
+                   [&](idx i, idx j) -> bool
+                   {
+                     return (fractional_sums[i] - control_sums[i]) >
+                       (fractional_sums[j] - control_sums[j]);
+                   });
+
+  for(const idx control : order)
+  {
+    ++control_sums[control];
+
+    if(sum_oracle.is_viable(index, control_sums))
+    {
+      controls(vertex)[control] = 1.;
+
+      double next_cost = cost;
+
+      for(const Edge& incoming : graph.get_incoming(vertex))
+      {
+        next_cost += costs(incoming,
+                           controls(incoming.get_source()),
+                           controls(vertex));
+      }
+
+      if(cmp::lt(next_cost, best_cost))
+      {
+        search(first,
+               index + 1,
+               (index == first) ? control : first_control,
+               next_cost);
+      }
+
+      controls(vertex)[control] = 0.;
+    }
+
+    --control_sums[control];
+  }
+}
+
+VertexMap<Controls> LookaheadSUR::solve()
+{
+  Timer timer;
+
+  controls = VertexMap<Controls>(graph, Controls(dimension, 0.));
+  std::fill(std::begin(control_sums), std::end(control_sums), 0);
+
+  idx index = 0;
+
+  for(const Vertex& vertex : graph.get_vertices())
+  {
+    best_cost = inf;
+
+    search(index, index, 0, 0.);
+
+    // viable sums can always be extended
+    assert(best_cost < inf);
+
+    controls(vertex)[best_control] = 1.;
+    ++control_sums[best_control];
+
+    ++index;
+  }
+
+  Log(info) << "Computed lookahead SUR controls with a window of "
+            << window
+            << " vertices in "
+            << timer.elapsed()
+            << "s";
+
+  assert(controls_are_integral(graph, controls));
+  assert(controls_are_convex(graph, controls));
+  assert(cmp::le(control_distance(graph, fractional_controls, controls),
+                 upper_bound));
+
+  return controls;
+}
+
+VertexMap<Controls>
+compute_lookahead_sur_controls(const Graph& graph,
+                               const VertexMap<Controls>& fractional_controls,
+                               const CostFunction& costs,
+                               idx window)
+{
+  return LookaheadSUR(graph, costs, fractional_controls, window).solve();
+}
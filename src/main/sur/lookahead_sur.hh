@@ -0,0 +1,76 @@
+#ifndef LOOKAHEAD_SUR_HH
+#define LOOKAHEAD_SUR_HH
+
+#include <vector>
+
+#include "control_sums.hh"
+#include "controls.hh"
+#include "cost_function.hh"
+#include "graph/graph.hh"
+#include "graph/vertex_map.hh"
+
+/**
+ * A variant of sum-up rounding which takes the switching costs into
+ * account: At each vertex, the controls of the next vertices (up to the
+ * size of the window) are chosen by an exhaustive search minimizing the
+ * costs of the Edge%s between the current and previous vertices. Only
+ * the control of the current vertex is committed, afterwards the
+ * window is moved forward by one vertex.
+ *
+ * Partial assignments whose control sums are not viable with respect
+ * to a SumOracle are pruned, which guarantees that the upper bound
+ * is satisfied. Partial assignments whose costs exceed the best one
+ * are pruned as well (assuming non-negative costs). Ties are broken
+ * in favor of the controls with the largest deviations, so the
+ * rounding resembles SUR in the absence of switching costs.
+ * The running time is O(n * dimension^window).
+ **/
+class LookaheadSUR
+{
+private:
+  const Graph& graph;
+  const CostFunction& costs;
+  const VertexMap<Controls>& fractional_controls;
+  const idx window;
+
+  const Vertex source;
+  const idx dimension;
+  const double upper_bound;
+
+  const SumOracle sum_oracle;
+
+  // the sums of the fractional controls after each vertex
+  std::vector<Controls> fractional_control_sums;
+
+  VertexMap<Controls> controls;
+  std::vector<idx> control_sums;
+
+  // the order in which the controls are tried at each depth
+  std::vector<std::vector<idx>> orders;
+
+  double best_cost;
+  idx best_control;
+
+  void search(idx first, idx index, idx first_control, double cost);
+
+public:
+  /**
+   * Constructs a new LookaheadSUR with the given window size.
+   * Throws an std::invalid_argument if the window is empty
+   * or the instance is infeasible.
+   **/
+  LookaheadSUR(const Graph& graph,
+               const CostFunction& costs,
+               const VertexMap<Controls>& fractional_controls,
+               idx window);
+
+  VertexMap<Controls> solve();
+};
+
+VertexMap<Controls>
+compute_lookahead_sur_controls(const Graph& graph,
+                               const VertexMap<Controls>& fractional_controls,
+                               const CostFunction& costs,
+                               idx window);
+
+#endif /* LOOKAHEAD_SUR_HH */
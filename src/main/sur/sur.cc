@@ -1,10 +1,67 @@
 #include "sur.hh"
 
+#include <cmath>
 #include <stdexcept>
 
+#include "control_reader.hh"
+#include "control_writer.hh"
 #include "controls.hh"
 #include "log.hh"
 
+SURRounder::SURRounder(idx dimension,
+                       bool vanishing_constraints,
+                       double eps)
+  : dimension(dimension),
+    vanishing_constraints(vanishing_constraints),
+    eps(eps),
+    fractional_control_sums(dimension, 0.),
+    control_sums(dimension, 0),
+    distance(0.)
+{
+}
+
+idx SURRounder::round(const Controls& fractional_controls)
+{
+  assert(fractional_controls.size() == dimension);
+
+  idx next_control;
+  double next_val = -inf;
+
+  for(idx i = 0; i < dimension; ++i)
+  {
+    fractional_control_sums[i] += fractional_controls[i];
+  }
+
+  for(idx i = 0; i < dimension; ++i)
+  {
+    double val = fractional_control_sums[i] - ((double) control_sums[i]);
+
+    if(vanishing_constraints)
+    {
+      if(cmp::zero(fractional_controls[i], eps))
+      {
+        continue;
+      }
+    }
+
+    if(val > next_val)
+    {
+      next_val = val;
+      next_control = i;
+    }
+  }
+
+  ++control_sums[next_control];
+
+  for(idx i = 0; i < dimension; ++i)
+  {
+    distance = std::max(distance,
+                        std::fabs(fractional_control_sums[i] - ((double) control_sums[i])));
+  }
+
+  return next_control;
+}
+
 VertexMap<Controls>
 compute_sur_controls(const Graph& graph,
                      const VertexMap<Controls>& fractional_controls,
@@ -22,58 +79,63 @@ compute_sur_controls(const Graph& graph,
 
   assert(controls_are_convex(graph, fractional_controls));
 
-  const double upper_bound = max_control_deviation(dimension);
-
   VertexMap<Controls> sur_controls(graph, Controls(dimension, 0.));
 
-  idx previous_control = 0;
+  SURRounder rounder(dimension, vanishing_constraints, eps);
 
-  std::vector<double> fractional_control_sums(dimension, 0.);
+  for(const Vertex& vertex : graph.get_vertices())
+  {
+    sur_controls(vertex).at(rounder.round(fractional_controls(vertex))) = 1;
+  }
 
-  std::vector<idx> control_sums(dimension, 0);
+  assert(controls_are_integral(graph, sur_controls));
+  assert(controls_are_convex(graph, sur_controls));
 
-  auto add_fractional_controls = [&](Vertex vertex)
-    {
-      for(idx i = 0; i < dimension; ++i)
-      {
-        fractional_control_sums.at(i) += fractional_controls(vertex).at(i);
-      }
-    };
+  return sur_controls;
+}
 
-  for(const Vertex& vertex : graph.get_vertices())
+double stream_sur_controls(std::istream& input,
+                           std::ostream& output,
+                           bool vanishing_constraints,
+                           double eps)
+{
+  ControlRowReader reader(input);
+
+  Point point;
+  Controls fractional_controls;
+
+  if(!reader.read(point, fractional_controls))
   {
-    idx next_control;
-    double next_val = -inf;
+    throw std::invalid_argument("Graph is too small");
+  }
 
-    add_fractional_controls(vertex);
+  const idx dimension = fractional_controls.size();
 
-    for(idx i = 0; i < dimension; ++i)
-    {
-      double val = fractional_control_sums.at(i) - ((double) control_sums.at(i));
+  SURRounder rounder(dimension, vanishing_constraints, eps);
 
-      if(vanishing_constraints)
-      {
-        if(cmp::zero(fractional_controls(vertex).at(i), eps))
-        {
-          continue;
-        }
-      }
+  Controls sur_controls(dimension, 0.);
 
-      if(val > next_val)
-      {
-        next_val = val;
-        next_control = i;
-      }
+  do
+  {
+    if(!controls_are_convex(fractional_controls))
+    {
+      throw std::invalid_argument("Controls are not convex");
     }
 
-    sur_controls(vertex).at(next_control) = 1;
-    ++control_sums[next_control];
+    const idx control = rounder.round(fractional_controls);
 
-    previous_control = next_control;
+    sur_controls[control] = 1.;
+
+    write_control_row(point, sur_controls, output);
+
+    sur_controls[control] = 0.;
   }
+  while(reader.read(point, fractional_controls));
 
-  assert(controls_are_integral(graph, sur_controls));
-  assert(controls_are_convex(graph, sur_controls));
+  Log(info) << "Computed SUR controls for "
+            << reader.get_num_rows()
+            << " streamed vertices with dimension "
+            << dimension;
 
-  return sur_controls;
+  return rounder.get_distance();
 }
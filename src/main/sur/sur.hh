@@ -1,12 +1,53 @@
 #ifndef SUR_HH
 #define SUR_HH
 
+#include <iostream>
+#include <vector>
+
 #include "cmp.hh"
 #include "controls.hh"
 #include "cost_function.hh"
 #include "graph/graph.hh"
 #include "graph/vertex_map.hh"
 
+/**
+ * Performs sum-up rounding one vertex at a time, keeping
+ * only the sums of the fractional and rounded controls
+ * of the previous vertices.
+ **/
+class SURRounder
+{
+private:
+  const idx dimension;
+  const bool vanishing_constraints;
+  const double eps;
+
+  std::vector<double> fractional_control_sums;
+  std::vector<idx> control_sums;
+
+  double distance;
+
+public:
+  SURRounder(idx dimension,
+             bool vanishing_constraints = false,
+             double eps = cmp::eps);
+
+  /**
+   * Rounds the fractional controls of the next vertex,
+   * returning the index of the chosen control.
+   **/
+  idx round(const Controls& fractional_controls);
+
+  /**
+   * Returns the maximum deviation between the sums of the
+   * fractional and the rounded controls so far.
+   **/
+  double get_distance() const
+  {
+    return distance;
+  }
+};
+
 VertexMap<Controls>
 compute_sur_controls(const Graph& graph,
                      const VertexMap<Controls>& fractional_controls,
@@ -14,4 +55,16 @@ compute_sur_controls(const Graph& graph,
                      bool vanishing_constraints = false,
                      double eps = cmp::eps);
 
+/**
+ * Rounds the controls read from the input (in the format of
+ * read_file()) row by row, writing each rounded row immediately
+ * to the output (in the format of write_controls()). The memory
+ * requirements are independent of the number of vertices. Returns
+ * the distance between the fractional and rounded controls.
+ **/
+double stream_sur_controls(std::istream& input,
+                           std::ostream& output,
+                           bool vanishing_constraints = false,
+                           double eps = cmp::eps);
+
 #endif /* SUR_HH */
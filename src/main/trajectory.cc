@@ -0,0 +1,67 @@
+#include "trajectory.hh"
+
+#include <cmath>
+
+#include "util.hh"
+
+double relative_gap(const TrajectoryPoint& point)
+{
+  if(point.incumbent == inf)
+  {
+    return inf;
+  }
+
+  if(point.incumbent == point.bound)
+  {
+    return 0.;
+  }
+
+  if(point.incumbent == 0.)
+  {
+    return inf;
+  }
+
+  return std::abs(point.incumbent - point.bound) / std::abs(point.incumbent);
+}
+
+std::optional<double> time_to_feasible(const Trajectory& trajectory)
+{
+  for(const TrajectoryPoint& point : trajectory)
+  {
+    if(point.incumbent != inf)
+    {
+      return point.time;
+    }
+  }
+
+  return {};
+}
+
+std::optional<double> time_to_gap(const Trajectory& trajectory,
+                                  double gap)
+{
+  for(const TrajectoryPoint& point : trajectory)
+  {
+    if(relative_gap(point) <= gap)
+    {
+      return point.time;
+    }
+  }
+
+  return {};
+}
+
+void write_trajectory(const Trajectory& trajectory,
+                      std::ostream& output)
+{
+  output << "Time;Incumbent;Bound;Nodes" << std::endl;
+
+  for(const TrajectoryPoint& point : trajectory)
+  {
+    output << point.time << ";"
+           << point.incumbent << ";"
+           << point.bound << ";"
+           << point.nodes
+           << std::endl;
+  }
+}
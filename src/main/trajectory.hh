@@ -0,0 +1,43 @@
+#ifndef TRAJECTORY_HH
+#define TRAJECTORY_HH
+
+#include <iostream>
+#include <optional>
+#include <vector>
+
+/**
+ * The state of a branch-and-bound at a given point in time.
+ * The incumbent is infinite as long as no solution is known.
+ **/
+struct TrajectoryPoint
+{
+  double time;
+  double incumbent;
+  double bound;
+  double nodes;
+};
+
+typedef std::vector<TrajectoryPoint> Trajectory;
+
+/**
+ * Returns the relative gap between the incumbent and the bound
+ * (relative to the incumbent, as in Gurobi).
+ **/
+double relative_gap(const TrajectoryPoint& point);
+
+/**
+ * Returns the time at which the first solution was found.
+ **/
+std::optional<double> time_to_feasible(const Trajectory& trajectory);
+
+/**
+ * Returns the time at which the relative gap first
+ * dropped below the given value.
+ **/
+std::optional<double> time_to_gap(const Trajectory& trajectory,
+                                  double gap);
+
+void write_trajectory(const Trajectory& trajectory,
+                      std::ostream& output);
+
+#endif /* TRAJECTORY_HH */
@@ -0,0 +1,157 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <stdexcept>
+
+#include "decomposition.hh"
+#include "grid.hh"
+#include "scarp/scarp_program.hh"
+
+#include "test_fixture.hh"
+
+VertexMap<Controls> solve_scarp(const Graph& graph,
+                                const CostFunction& costs,
+                                const VertexMap<Controls>& fractional_controls)
+{
+  return SCARPProgram(graph, costs, fractional_controls).solve();
+}
+
+TEST_F(TestInstances, test_decomposition_solve)
+{
+  for(const auto& test_instance : test_instances)
+  {
+    auto result = test_instance.read();
+
+    const Vertex source = *result.graph.get_vertices().begin();
+    const idx dimension = result.fractional_controls(source).size();
+
+    const idx grid_length = compute_grid_length(result.graph,
+                                                result.coordinates);
+
+    const double scale_factor = 1. / ((double) grid_length);
+
+    auto costs = VariationalCosts(scale_factor);
+
+    DecompositionSolver solver(result.graph,
+                               costs,
+                               result.fractional_controls,
+                               result.coordinates,
+                               solve_scarp,
+                               std::max(grid_length / 4, (idx) 1),
+                               1,
+                               2);
+
+    auto decomposed_controls = solver.solve();
+
+    const double upper_bound = max_control_deviation(dimension);
+
+    const double distance = control_distance(result.graph,
+                                             result.fractional_controls,
+                                             decomposed_controls);
+
+    const double control_cost = costs.evaluate(result.graph, decomposed_controls);
+
+    EXPECT_GT(solver.get_num_tiles(), 1);
+
+    EXPECT_TRUE(controls_are_convex(result.graph,
+                                    decomposed_controls));
+
+    EXPECT_TRUE(controls_are_integral(result.graph,
+                                      decomposed_controls));
+
+    EXPECT_TRUE(cmp::le(distance, upper_bound));
+
+    EXPECT_TRUE(cmp::ge(control_cost, test_instance.get_optimal_objective()));
+  }
+}
+
+TEST_F(TestInstances, test_single_tile_solve)
+{
+  for(const auto& test_instance : test_instances)
+  {
+    auto result = test_instance.read();
+
+    const idx grid_length = compute_grid_length(result.graph,
+                                                result.coordinates);
+
+    const double scale_factor = 1. / ((double) grid_length);
+
+    auto costs = VariationalCosts(scale_factor);
+
+    DecompositionSolver solver(result.graph,
+                               costs,
+                               result.fractional_controls,
+                               result.coordinates,
+                               solve_scarp,
+                               grid_length);
+
+    auto decomposed_controls = solver.solve();
+
+    auto scarp_controls = solve_scarp(result.graph,
+                                      costs,
+                                      result.fractional_controls);
+
+    EXPECT_EQ(solver.get_num_tiles(), 1);
+    EXPECT_EQ(solver.get_num_repaired(), 0);
+
+    EXPECT_TRUE(cmp::eq(costs.evaluate(result.graph, decomposed_controls),
+                        costs.evaluate(result.graph, scarp_controls)));
+  }
+}
+
+TEST_F(TestInstances, test_failed_tile_solve)
+{
+  for(const auto& test_instance : test_instances)
+  {
+    auto result = test_instance.read();
+
+    const Vertex source = *result.graph.get_vertices().begin();
+    const idx dimension = result.fractional_controls(source).size();
+
+    const idx grid_length = compute_grid_length(result.graph,
+                                                result.coordinates);
+
+    const double scale_factor = 1. / ((double) grid_length);
+
+    auto costs = VariationalCosts(scale_factor);
+
+    std::atomic<idx> num_calls(0);
+
+    // every other tile fails
+    auto solve_some = [&](const Graph& graph,
+                          const CostFunction& costs,
+                          const VertexMap<Controls>& fractional_controls)
+      {
+        if(num_calls++ % 2 == 0)
+        {
+          throw std::runtime_error("Failed to solve tile");
+        }
+
+        return solve_scarp(graph, costs, fractional_controls);
+      };
+
+    DecompositionSolver solver(result.graph,
+                               costs,
+                               result.fractional_controls,
+                               result.coordinates,
+                               solve_some,
+                               std::max(grid_length / 4, (idx) 1),
+                               1,
+                               2);
+
+    auto decomposed_controls = solver.solve();
+
+    EXPECT_GT(solver.get_num_failed(), 0);
+
+    EXPECT_TRUE(controls_are_convex(result.graph,
+                                    decomposed_controls));
+
+    EXPECT_TRUE(controls_are_integral(result.graph,
+                                      decomposed_controls));
+
+    EXPECT_TRUE(cmp::le(control_distance(result.graph,
+                                         result.fractional_controls,
+                                         decomposed_controls),
+                        max_control_deviation(dimension)));
+  }
+}
@@ -48,5 +48,100 @@ TEST_F(TestInstances, test_scarp_solve)
     EXPECT_TRUE(cmp::le(distance, upper_bound));
 
     EXPECT_TRUE(cmp::eq(control_cost, test_instance.get_optimal_objective()));
+
+    EXPECT_TRUE(program.is_optimal());
+  }
+}
+
+TEST_F(TestInstances, test_history_solve)
+{
+  for(const auto& test_instance : test_instances)
+  {
+    auto result = test_instance.read();
+
+    const Vertex source = *result.graph.get_vertices().begin();
+    const idx dimension = result.fractional_controls(source).size();
+
+    const idx grid_length = compute_grid_length(result.graph,
+                                                result.coordinates);
+
+    const double scale_factor = 1. / ((double) grid_length);
+
+    auto costs = VariationalCosts(scale_factor);
+
+    const double upper_bound = max_control_deviation(dimension);
+
+    for(idx history_length : {1, 2, 4})
+    {
+      ExactProgram program(result.graph,
+                           costs,
+                           result.fractional_controls,
+                           false,
+                           history_length);
+
+      auto hybrid_controls = program.solve();
+
+      const double distance = control_distance(result.graph,
+                                               result.fractional_controls,
+                                               hybrid_controls);
+
+      const double control_cost = costs.evaluate(result.graph, hybrid_controls);
+
+      EXPECT_TRUE(controls_are_convex(result.graph,
+                                      hybrid_controls));
+
+      EXPECT_TRUE(controls_are_integral(result.graph,
+                                        hybrid_controls));
+
+      EXPECT_TRUE(cmp::le(distance, upper_bound));
+
+      EXPECT_TRUE(cmp::ge(control_cost, test_instance.get_optimal_objective()));
+    }
+  }
+}
+
+TEST_F(TestInstances, test_budget_solve)
+{
+  for(const auto& test_instance : test_instances)
+  {
+    auto result = test_instance.read();
+
+    const Vertex source = *result.graph.get_vertices().begin();
+    const idx dimension = result.fractional_controls(source).size();
+
+    const idx grid_length = compute_grid_length(result.graph,
+                                                result.coordinates);
+
+    const double scale_factor = 1. / ((double) grid_length);
+
+    auto costs = VariationalCosts(scale_factor);
+
+    const double upper_bound = max_control_deviation(dimension);
+
+    ExactProgram program(result.graph,
+                         costs,
+                         result.fractional_controls);
+
+    program.set_label_limit(1);
+
+    auto budget_controls = program.solve();
+
+    const double distance = control_distance(result.graph,
+                                             result.fractional_controls,
+                                             budget_controls);
+
+    const double control_cost = costs.evaluate(result.graph, budget_controls);
+
+    EXPECT_TRUE(controls_are_convex(result.graph,
+                                    budget_controls));
+
+    EXPECT_TRUE(controls_are_integral(result.graph,
+                                      budget_controls));
+
+    EXPECT_TRUE(cmp::le(distance, upper_bound));
+
+    EXPECT_TRUE(cmp::ge(control_cost, test_instance.get_optimal_objective()));
+
+    EXPECT_FALSE(program.is_optimal());
   }
 }
@@ -2,6 +2,10 @@
 
 #include "grid.hh"
 #include "dag_program.hh"
+#include "neighborhood_search.hh"
+#include "portfolio.hh"
+
+#include "sur/sur.hh"
 
 #include "test_fixture.hh"
 
@@ -49,3 +53,385 @@ TEST_F(TestInstances, test_mip_solve)
     EXPECT_TRUE(cmp::eq(control_cost, test_instance.get_optimal_objective()));
   }
 }
+
+TEST_F(TestInstances, test_cumulative_mip_solve)
+{
+  for(const auto& test_instance : test_instances)
+  {
+    auto result = test_instance.read();
+
+    ASSERT_TRUE(controls_are_convex(result.graph,
+                                    result.fractional_controls));
+
+    const Vertex source = *result.graph.get_vertices().begin();
+    const idx dimension = result.fractional_controls(source).size();
+
+    const idx grid_length = compute_grid_length(result.graph,
+                                                result.coordinates);
+
+    const double scale_factor = 1. / ((double) grid_length);
+
+    auto costs = VariationalCosts(scale_factor);
+
+    DAGProgram program(result.graph,
+                       result.fractional_controls,
+                       costs,
+                       Formulation::CUMULATIVE);
+
+    auto mip_controls = program.solve();
+
+    const double upper_bound = max_control_deviation(dimension);
+
+    const double distance = control_distance(result.graph,
+                                             result.fractional_controls,
+                                             mip_controls);
+
+    const double control_cost = costs.evaluate(result.graph, mip_controls);
+
+    EXPECT_TRUE(controls_are_convex(result.graph,
+                                    mip_controls));
+
+    EXPECT_TRUE(controls_are_integral(result.graph,
+                                      mip_controls));
+
+    EXPECT_TRUE(cmp::le(distance, upper_bound));
+
+    EXPECT_TRUE(cmp::eq(control_cost, test_instance.get_optimal_objective()));
+  }
+}
+
+TEST_F(TestInstances, test_callback_mip_solve)
+{
+  for(const auto& test_instance : test_instances)
+  {
+    auto result = test_instance.read();
+
+    ASSERT_TRUE(controls_are_convex(result.graph,
+                                    result.fractional_controls));
+
+    const Vertex source = *result.graph.get_vertices().begin();
+    const idx dimension = result.fractional_controls(source).size();
+
+    const idx grid_length = compute_grid_length(result.graph,
+                                                result.coordinates);
+
+    const double scale_factor = 1. / ((double) grid_length);
+
+    auto costs = VariationalCosts(scale_factor);
+
+    DAGProgram program(result.graph,
+                       result.fractional_controls,
+                       costs);
+
+    program.enable_heuristic_callback();
+
+    auto mip_controls = program.solve();
+
+    const double upper_bound = max_control_deviation(dimension);
+
+    const double distance = control_distance(result.graph,
+                                             result.fractional_controls,
+                                             mip_controls);
+
+    const double control_cost = costs.evaluate(result.graph, mip_controls);
+
+    EXPECT_TRUE(controls_are_convex(result.graph,
+                                    mip_controls));
+
+    EXPECT_TRUE(controls_are_integral(result.graph,
+                                      mip_controls));
+
+    EXPECT_TRUE(cmp::le(distance, upper_bound));
+
+    EXPECT_TRUE(cmp::eq(control_cost, test_instance.get_optimal_objective()));
+  }
+}
+
+TEST_F(TestInstances, test_lazy_mip_solve)
+{
+  for(const auto& test_instance : test_instances)
+  {
+    auto result = test_instance.read();
+
+    ASSERT_TRUE(controls_are_convex(result.graph,
+                                    result.fractional_controls));
+
+    const Vertex source = *result.graph.get_vertices().begin();
+    const idx dimension = result.fractional_controls(source).size();
+
+    const idx grid_length = compute_grid_length(result.graph,
+                                                result.coordinates);
+
+    const double scale_factor = 1. / ((double) grid_length);
+
+    auto costs = VariationalCosts(scale_factor);
+
+    DAGProgram program(result.graph,
+                       result.fractional_controls,
+                       costs,
+                       Formulation::LAZY);
+
+    auto mip_controls = program.solve();
+
+    const double upper_bound = max_control_deviation(dimension);
+
+    const double distance = control_distance(result.graph,
+                                             result.fractional_controls,
+                                             mip_controls);
+
+    const double control_cost = costs.evaluate(result.graph, mip_controls);
+
+    EXPECT_TRUE(controls_are_convex(result.graph,
+                                    mip_controls));
+
+    EXPECT_TRUE(controls_are_integral(result.graph,
+                                      mip_controls));
+
+    EXPECT_TRUE(cmp::le(distance, upper_bound));
+
+    EXPECT_TRUE(cmp::eq(control_cost, test_instance.get_optimal_objective()));
+  }
+}
+
+TEST_F(TestInstances, test_update_mip_solve)
+{
+  for(const auto& test_instance : test_instances)
+  {
+    auto result = test_instance.read();
+
+    const Vertex source = *result.graph.get_vertices().begin();
+    const idx dimension = result.fractional_controls(source).size();
+
+    const idx grid_length = compute_grid_length(result.graph,
+                                                result.coordinates);
+
+    const double scale_factor = 1. / ((double) grid_length);
+
+    auto costs = VariationalCosts(scale_factor);
+
+    // permute the controls to obtain a different instance
+    VertexMap<Controls> permuted_controls(result.graph, Controls(dimension, 0.));
+
+    for(const Vertex& vertex : result.graph.get_vertices())
+    {
+      for(idx i = 0; i < dimension; ++i)
+      {
+        permuted_controls(vertex).at((i + 1) % dimension) = result.fractional_controls(vertex).at(i);
+      }
+    }
+
+    for(Formulation formulation : {Formulation::DENSE,
+                                   Formulation::CUMULATIVE,
+                                   Formulation::LAZY})
+    {
+      DAGProgram program(result.graph,
+                         permuted_controls,
+                         costs,
+                         formulation);
+
+      program.solve();
+
+      program.update_fractional_controls(result.fractional_controls);
+
+      auto mip_controls = program.solve();
+
+      const double upper_bound = max_control_deviation(dimension);
+
+      const double distance = control_distance(result.graph,
+                                               result.fractional_controls,
+                                               mip_controls);
+
+      const double control_cost = costs.evaluate(result.graph, mip_controls);
+
+      EXPECT_TRUE(controls_are_convex(result.graph,
+                                      mip_controls));
+
+      EXPECT_TRUE(controls_are_integral(result.graph,
+                                        mip_controls));
+
+      EXPECT_TRUE(cmp::le(distance, upper_bound));
+
+      EXPECT_TRUE(cmp::eq(control_cost, test_instance.get_optimal_objective()));
+    }
+  }
+}
+
+TEST_F(TestInstances, test_trajectory_mip_solve)
+{
+  for(const auto& test_instance : test_instances)
+  {
+    auto result = test_instance.read();
+
+    ASSERT_TRUE(controls_are_convex(result.graph,
+                                    result.fractional_controls));
+
+    const Vertex source = *result.graph.get_vertices().begin();
+    const idx dimension = result.fractional_controls(source).size();
+
+    const idx grid_length = compute_grid_length(result.graph,
+                                                result.coordinates);
+
+    const double scale_factor = 1. / ((double) grid_length);
+
+    auto costs = VariationalCosts(scale_factor);
+
+    DAGProgram program(result.graph,
+                       result.fractional_controls,
+                       costs);
+
+    program.enable_trajectory();
+
+    auto mip_controls = program.solve();
+
+    const double upper_bound = max_control_deviation(dimension);
+
+    const double distance = control_distance(result.graph,
+                                             result.fractional_controls,
+                                             mip_controls);
+
+    const double control_cost = costs.evaluate(result.graph, mip_controls);
+
+    EXPECT_TRUE(controls_are_convex(result.graph,
+                                    mip_controls));
+
+    EXPECT_TRUE(controls_are_integral(result.graph,
+                                      mip_controls));
+
+    EXPECT_TRUE(cmp::le(distance, upper_bound));
+
+    EXPECT_TRUE(cmp::eq(control_cost, test_instance.get_optimal_objective()));
+
+    const Trajectory trajectory = program.get_trajectory();
+
+    ASSERT_FALSE(trajectory.empty());
+
+    EXPECT_TRUE(cmp::eq(trajectory.back().incumbent, control_cost));
+
+    EXPECT_TRUE(time_to_feasible(trajectory).has_value());
+    EXPECT_TRUE(time_to_gap(trajectory, 0.01).has_value());
+  }
+}
+
+TEST_F(TestInstances, test_lower_bound)
+{
+  for(const auto& test_instance : test_instances)
+  {
+    auto result = test_instance.read();
+
+    const idx grid_length = compute_grid_length(result.graph,
+                                                result.coordinates);
+
+    const double scale_factor = 1. / ((double) grid_length);
+
+    auto costs = VariationalCosts(scale_factor);
+
+    const double lower_bound = compute_lower_bound(result.graph,
+                                                   result.fractional_controls,
+                                                   costs);
+
+    EXPECT_TRUE(cmp::le(lower_bound, test_instance.get_optimal_objective()));
+  }
+}
+
+TEST_F(TestInstances, test_neighborhood_search)
+{
+  for(const auto& test_instance : test_instances)
+  {
+    auto result = test_instance.read();
+
+    const Vertex source = *result.graph.get_vertices().begin();
+    const idx dimension = result.fractional_controls(source).size();
+    const idx size = result.graph.get_vertices().size();
+
+    const idx grid_length = compute_grid_length(result.graph,
+                                                result.coordinates);
+
+    const double scale_factor = 1. / ((double) grid_length);
+
+    auto costs = VariationalCosts(scale_factor);
+
+    auto sur_controls = compute_sur_controls(result.graph,
+                                             result.fractional_controls,
+                                             costs);
+
+    const double sur_cost = costs.evaluate(result.graph, sur_controls);
+
+    const double upper_bound = max_control_deviation(dimension);
+
+    NeighborhoodSearch search(result.graph,
+                              result.fractional_controls,
+                              costs,
+                              size / 4,
+                              2);
+
+    auto improved_controls = search.improve(sur_controls);
+
+    EXPECT_TRUE(controls_are_convex(result.graph,
+                                    improved_controls));
+
+    EXPECT_TRUE(controls_are_integral(result.graph,
+                                      improved_controls));
+
+    EXPECT_TRUE(cmp::le(control_distance(result.graph,
+                                         result.fractional_controls,
+                                         improved_controls),
+                        upper_bound));
+
+    const double improved_cost = costs.evaluate(result.graph, improved_controls);
+
+    EXPECT_TRUE(cmp::le(improved_cost, sur_cost));
+    EXPECT_TRUE(cmp::ge(improved_cost, test_instance.get_optimal_objective()));
+
+    // a single window covering the whole graph yields an optimal solution
+    NeighborhoodSearch full_search(result.graph,
+                                   result.fractional_controls,
+                                   costs,
+                                   size);
+
+    auto optimal_controls = full_search.improve_windows(sur_controls);
+
+    EXPECT_TRUE(cmp::eq(costs.evaluate(result.graph, optimal_controls),
+                        test_instance.get_optimal_objective()));
+  }
+}
+
+TEST_F(TestInstances, test_portfolio_solve)
+{
+  for(const auto& test_instance : test_instances)
+  {
+    auto result = test_instance.read();
+
+    const Vertex source = *result.graph.get_vertices().begin();
+    const idx dimension = result.fractional_controls(source).size();
+
+    const idx grid_length = compute_grid_length(result.graph,
+                                                result.coordinates);
+
+    const double scale_factor = 1. / ((double) grid_length);
+
+    auto costs = VariationalCosts(scale_factor);
+
+    Portfolio portfolio(result.graph,
+                        result.fractional_controls,
+                        costs);
+
+    const PortfolioResult portfolio_result = portfolio.solve();
+
+    const double upper_bound = max_control_deviation(dimension);
+
+    EXPECT_TRUE(portfolio_result.optimal);
+
+    EXPECT_TRUE(portfolio_result.solver == PortfolioSolver::EXACT ||
+                portfolio_result.solver == PortfolioSolver::MIP);
+
+    EXPECT_TRUE(controls_are_integral(result.graph,
+                                      portfolio_result.controls));
+
+    EXPECT_TRUE(cmp::le(control_distance(result.graph,
+                                         result.fractional_controls,
+                                         portfolio_result.controls),
+                        upper_bound));
+
+    EXPECT_TRUE(cmp::eq(portfolio_result.costs, test_instance.get_optimal_objective()));
+  }
+}
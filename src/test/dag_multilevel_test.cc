@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+
+#include "grid.hh"
+#include "multilevel.hh"
+#include "scarp/scarp_program.hh"
+
+#include "test_fixture.hh"
+
+TEST_F(TestInstances, test_coarsen_grid)
+{
+  for(const auto& test_instance : test_instances)
+  {
+    auto result = test_instance.read();
+
+    const CoarseGrid coarse_grid = coarsen_grid(result.graph,
+                                                result.fractional_controls,
+                                                result.coordinates);
+
+    const idx num_vertices = result.graph.get_vertices().size();
+    const idx num_coarse_vertices = coarse_grid.graph.get_vertices().size();
+
+    EXPECT_LT(num_coarse_vertices, num_vertices);
+    EXPECT_GE(4 * num_coarse_vertices, num_vertices);
+
+    EXPECT_TRUE(controls_are_convex(coarse_grid.graph,
+                                    coarse_grid.fractional_controls));
+
+    // the coarse edges connect the parents of the original edges
+    for(const Edge& edge : coarse_grid.graph.get_edges())
+    {
+      const Edge& original_edge = coarse_grid.original_edges(edge);
+
+      Vertex source = coarse_grid.parents(original_edge.get_source());
+      Vertex target = coarse_grid.parents(original_edge.get_target());
+
+      if(coarse_grid.reversed_edges.contains(edge))
+      {
+        std::swap(source, target);
+      }
+
+      EXPECT_EQ(source, edge.get_source());
+      EXPECT_EQ(target, edge.get_target());
+    }
+  }
+}
+
+TEST_F(TestInstances, test_multilevel_solve)
+{
+  for(const auto& test_instance : test_instances)
+  {
+    auto result = test_instance.read();
+
+    const Vertex source = *result.graph.get_vertices().begin();
+    const idx dimension = result.fractional_controls(source).size();
+
+    const idx grid_length = compute_grid_length(result.graph,
+                                                result.coordinates);
+
+    const double scale_factor = 1. / ((double) grid_length);
+
+    auto costs = VariationalCosts(scale_factor);
+
+    for(idx num_levels = 0; num_levels <= 2; ++num_levels)
+    {
+      MultilevelSCARP solver(result.graph,
+                             costs,
+                             result.fractional_controls,
+                             result.coordinates,
+                             num_levels,
+                             1);
+
+      auto multilevel_controls = solver.solve();
+
+      EXPECT_TRUE(controls_are_convex(result.graph,
+                                      multilevel_controls));
+
+      EXPECT_TRUE(controls_are_integral(result.graph,
+                                        multilevel_controls));
+
+      EXPECT_TRUE(cmp::le(control_distance(result.graph,
+                                           result.fractional_controls,
+                                           multilevel_controls),
+                          max_control_deviation(dimension)));
+
+      EXPECT_TRUE(cmp::ge(costs.evaluate(result.graph, multilevel_controls),
+                          test_instance.get_optimal_objective()));
+    }
+
+    // by default, the SCARPProgram is solved directly
+    MultilevelSCARP solver(result.graph,
+                           costs,
+                           result.fractional_controls,
+                           result.coordinates);
+
+    auto multilevel_controls = solver.solve();
+
+    SCARPProgram program(result.graph,
+                         costs,
+                         result.fractional_controls);
+
+    auto scarp_controls = program.solve();
+
+    EXPECT_EQ(solver.get_num_labels(), program.get_num_labels());
+    EXPECT_EQ(solver.get_num_widenings(), 0);
+
+    EXPECT_TRUE(cmp::eq(costs.evaluate(result.graph, multilevel_controls),
+                        costs.evaluate(result.graph, scarp_controls)));
+  }
+}
@@ -0,0 +1,44 @@
+#include <gtest/gtest.h>
+
+#include "control_reader.hh"
+
+#include "test_fixture.hh"
+
+TEST_F(TestInstances, test_sequence_reader)
+{
+  ASSERT_GE(test_instances.size(), 2);
+
+  SequenceReader reader;
+
+  {
+    fs::ifstream input{test_instances[0].get_path()};
+    reader.read(input);
+  }
+
+  fs::ifstream input{test_instances[0].get_path()};
+  const ReadResult& result = reader.read(input);
+
+  auto expected_result = test_instances[0].read();
+
+  ASSERT_EQ(result.graph.get_vertices().size(),
+            expected_result.graph.get_vertices().size());
+
+  for(const Vertex& vertex : result.graph.get_vertices())
+  {
+    EXPECT_EQ(result.fractional_controls(vertex),
+              expected_result.fractional_controls(vertex));
+  }
+
+  // a different grid is rejected
+  for(idx k = 1; k < test_instances.size(); ++k)
+  {
+    auto other_result = test_instances[k].read();
+
+    if(other_result.graph.get_vertices().size() != result.graph.get_vertices().size())
+    {
+      fs::ifstream other_input{test_instances[k].get_path()};
+      EXPECT_THROW(reader.read(other_input), std::invalid_argument);
+      break;
+    }
+  }
+}
@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+
+#include "grid.hh"
+#include "reordering.hh"
+#include "exact_scarp/exact_program.hh"
+#include "exact_scarp/reordered_program.hh"
+
+#include "test_fixture.hh"
+
+idx max_prefix_length(const Graph& graph)
+{
+  VertexMap<idx> prefix_map = get_prefix_map(graph);
+
+  idx max_length = 0;
+
+  for(const Vertex& vertex : graph.get_vertices())
+  {
+    max_length = std::max(max_length, prefix_map(vertex));
+  }
+
+  return max_length;
+}
+
+TEST_F(TestInstances, test_reordering)
+{
+  for(const auto& test_instance : test_instances)
+  {
+    auto result = test_instance.read();
+
+    Reordering reordering = reorder_graph(result.graph,
+                                          compute_bandwidth_order(result.graph));
+
+    // the order is topological, no edge is reversed
+    for(const Edge& edge : result.graph.get_edges())
+    {
+      EXPECT_TRUE(reordering.reordered_vertices(edge.get_source()) <
+                  reordering.reordered_vertices(edge.get_target()));
+    }
+
+    EXPECT_LE(max_prefix_length(reordering.graph),
+              max_prefix_length(result.graph));
+
+    auto reordered_controls = reorder_controls(reordering,
+                                               result.fractional_controls);
+
+    auto restored_controls = restore_controls(reordering,
+                                              result.graph,
+                                              reordered_controls);
+
+    for(const Vertex& vertex : result.graph.get_vertices())
+    {
+      EXPECT_EQ(restored_controls(vertex), result.fractional_controls(vertex));
+    }
+  }
+}
+
+TEST_F(TestInstances, test_reordered_solve)
+{
+  for(const auto& test_instance : test_instances)
+  {
+    auto result = test_instance.read();
+
+    const Vertex source = *result.graph.get_vertices().begin();
+    const idx dimension = result.fractional_controls(source).size();
+
+    const idx grid_length = compute_grid_length(result.graph,
+                                                result.coordinates);
+
+    const double scale_factor = 1. / ((double) grid_length);
+
+    auto costs = VariationalCosts(scale_factor);
+
+    ReorderedProgram program(result.graph,
+                             costs,
+                             result.fractional_controls);
+
+    auto exact_controls = program.solve();
+
+    const double upper_bound = max_control_deviation(dimension);
+
+    // the approximation constraints are checked in the original order
+    const double distance = control_distance(result.graph,
+                                             result.fractional_controls,
+                                             exact_controls);
+
+    EXPECT_TRUE(controls_are_convex(result.graph,
+                                    exact_controls));
+
+    EXPECT_TRUE(controls_are_integral(result.graph,
+                                      exact_controls));
+
+    EXPECT_EQ(program.is_feasible(), cmp::le(distance, upper_bound));
+
+    if(!program.is_feasible())
+    {
+      EXPECT_FALSE(program.is_optimal());
+      continue;
+    }
+
+    const double objective = costs.evaluate(result.graph, exact_controls);
+
+    EXPECT_TRUE(cmp::ge(objective, test_instance.get_optimal_objective()));
+
+    if(program.is_optimal())
+    {
+      EXPECT_TRUE(cmp::eq(objective, test_instance.get_optimal_objective()));
+    }
+  }
+}
+
+TEST(Reordering, test_reordered_dag)
+{
+  // two chains connected by the edges (i, i + 4), whose topological
+  // order is not unique: the bandwidth order interleaves the chains
+  Graph graph(8, {{0, 4}, {1, 5}, {2, 6}, {3, 7},
+                  {4, 5}, {5, 6}, {6, 7}});
+
+  const std::vector<Vertex> order = compute_bandwidth_order(graph);
+
+  const std::vector<idx> expected_order{0, 4, 1, 5, 2, 6, 3, 7};
+
+  ASSERT_EQ(order.size(), expected_order.size());
+
+  for(idx i = 0; i < order.size(); ++i)
+  {
+    EXPECT_EQ(order[i].get_index(), expected_order[i]);
+  }
+
+  VertexMap<Controls> fractional_controls(graph, Controls{0.5, 0.5});
+
+  auto costs = VariationalCosts();
+
+  ReorderedProgram program(graph, costs, fractional_controls);
+
+  const Reordering& reordering = program.get_reordering();
+
+  EXPECT_LT(max_prefix_length(reordering.graph),
+            max_prefix_length(graph));
+
+  auto exact_controls = program.solve();
+
+  EXPECT_TRUE(controls_are_convex(graph, exact_controls));
+
+  EXPECT_TRUE(controls_are_integral(graph, exact_controls));
+
+  // In the new order, the controls alternate between the chains,
+  // the optimum assigns equal controls along the second chain and
+  // the complementary controls along the first one
+  const double distance = control_distance(graph,
+                                           fractional_controls,
+                                           exact_controls);
+
+  EXPECT_TRUE(cmp::gt(distance, max_control_deviation(2)));
+
+  EXPECT_FALSE(program.is_feasible());
+
+  EXPECT_FALSE(program.is_optimal());
+}
@@ -1,5 +1,12 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <sstream>
+
+#include "control_reader.hh"
+#include "control_writer.hh"
 #include "grid.hh"
 #include "scarp/scarp_program.hh"
 
@@ -45,3 +52,221 @@ TEST_F(TestInstances, test_scarp_solve)
     EXPECT_TRUE(cmp::le(distance, upper_bound));
   }
 }
+
+TEST_F(TestInstances, test_rolling_scarp_solve)
+{
+  for(const auto& test_instance : test_instances)
+  {
+    auto result = test_instance.read();
+
+    const Vertex source = *result.graph.get_vertices().begin();
+    const idx dimension = result.fractional_controls(source).size();
+    const idx num_vertices = result.graph.get_vertices().size();
+
+    auto costs = VariationalCosts();
+
+    SCARPProgram program(result.graph,
+                         costs,
+                         result.fractional_controls);
+
+    const double scarp_costs = costs.evaluate(result.graph, program.solve());
+
+    for(idx window = 2; window <= 8; window *= 2)
+    {
+      auto rolling_controls = program.solve_rolling(window);
+
+      EXPECT_TRUE(controls_are_convex(result.graph,
+                                      rolling_controls));
+
+      EXPECT_TRUE(controls_are_integral(result.graph,
+                                        rolling_controls));
+
+      EXPECT_TRUE(cmp::le(control_distance(result.graph,
+                                           result.fractional_controls,
+                                           rolling_controls),
+                          max_control_deviation(dimension)));
+    }
+
+    // a window spanning all vertices yields the SCARP solution
+    auto rolling_controls = program.solve_rolling(num_vertices + 1);
+
+    EXPECT_TRUE(cmp::eq(costs.evaluate(result.graph, rolling_controls),
+                        scarp_costs));
+  }
+}
+
+TEST_F(TestInstances, test_incremental_scarp_solve)
+{
+  for(const auto& test_instance : test_instances)
+  {
+    auto result = test_instance.read();
+
+    const idx num_vertices = result.graph.get_vertices().size();
+
+    auto costs = VariationalCosts();
+
+    SCARPProgram program(result.graph,
+                         costs,
+                         result.fractional_controls);
+
+    program.solve();
+
+    // change the controls in the second half of the vertices
+    VertexMap<Controls> fractional_controls = result.fractional_controls;
+
+    for(idx index = num_vertices / 2; index < num_vertices; index += 3)
+    {
+      Controls& controls = fractional_controls(result.graph.get_vertices()[index]);
+
+      std::rotate(std::begin(controls), std::begin(controls) + 1, std::end(controls));
+    }
+
+    program.update_fractional_controls(fractional_controls);
+
+    auto incremental_controls = program.solve();
+
+    auto scarp_controls = SCARPProgram(result.graph,
+                                       costs,
+                                       fractional_controls).solve();
+
+    EXPECT_TRUE(controls_are_integral(result.graph,
+                                      incremental_controls));
+
+    EXPECT_TRUE(cmp::eq(control_distance(result.graph,
+                                         fractional_controls,
+                                         incremental_controls),
+                        control_distance(result.graph,
+                                         fractional_controls,
+                                         scarp_controls)));
+
+    EXPECT_TRUE(cmp::eq(costs.evaluate(result.graph, incremental_controls),
+                        costs.evaluate(result.graph, scarp_controls)));
+  }
+}
+
+TEST_F(TestInstances, test_interrupted_scarp_solve)
+{
+  for(const auto& test_instance : test_instances)
+  {
+    auto result = test_instance.read();
+
+    const idx grid_length = compute_grid_length(result.graph,
+                                                result.coordinates);
+
+    const double scale_factor = 1. / ((double) grid_length);
+
+    auto costs = VariationalCosts(scale_factor);
+
+    SCARPProgram program(result.graph,
+                         costs,
+                         result.fractional_controls);
+
+    std::atomic<bool> interrupt(true);
+
+    program.set_interrupt(&interrupt);
+
+    EXPECT_THROW(program.solve(), std::runtime_error);
+
+    EXPECT_THROW(program.solve_rolling(2), std::runtime_error);
+
+    interrupt = false;
+
+    auto scarp_controls = program.solve();
+
+    SCARPProgram other_program(result.graph,
+                               costs,
+                               result.fractional_controls);
+
+    auto other_controls = other_program.solve();
+
+    EXPECT_TRUE(cmp::eq(costs.evaluate(result.graph, scarp_controls),
+                        costs.evaluate(result.graph, other_controls)));
+  }
+}
+
+TEST_F(TestInstances, test_sequence_scarp_solve)
+{
+  for(const auto& test_instance : test_instances)
+  {
+    auto result = test_instance.read();
+
+    const Vertex source = *result.graph.get_vertices().begin();
+    const idx dimension = result.fractional_controls(source).size();
+    const idx num_vertices = result.graph.get_vertices().size();
+
+    const double upper_bound = max_control_deviation(dimension);
+
+    // a sequence of steps changing the controls
+    // on decreasing suffixes of the vertices
+    std::vector<std::string> steps;
+
+    VertexMap<Controls> fractional_controls = result.fractional_controls;
+
+    for(idx first : {num_vertices, num_vertices / 2, num_vertices / 4})
+    {
+      for(idx index = first; index < num_vertices; index += 3)
+      {
+        Controls& controls = fractional_controls(result.graph.get_vertices()[index]);
+
+        std::rotate(std::begin(controls), std::begin(controls) + 1, std::end(controls));
+      }
+
+      std::ostringstream output;
+      output.precision(17);
+
+      write_controls(result.graph,
+                     fractional_controls,
+                     result.coordinates,
+                     output);
+
+      steps.push_back(output.str());
+    }
+
+    // retained between the steps as in the sequence mode of the batch solver
+    SequenceReader reader;
+    std::unique_ptr<VariationalCosts> costs;
+    std::unique_ptr<SCARPProgram> sequence_program;
+
+    for(const std::string& step : steps)
+    {
+      std::istringstream input(step);
+      const ReadResult& step_result = reader.read(input);
+
+      if(sequence_program)
+      {
+        sequence_program->update_fractional_controls(step_result.fractional_controls);
+      }
+      else
+      {
+        const idx grid_length = compute_grid_length(step_result.graph,
+                                                    step_result.coordinates);
+
+        costs = std::make_unique<VariationalCosts>(1. / ((double) grid_length));
+
+        sequence_program = std::make_unique<SCARPProgram>(step_result.graph,
+                                                          *costs,
+                                                          step_result.fractional_controls);
+      }
+
+      auto sequence_controls = sequence_program->solve();
+
+      std::istringstream independent_input(step);
+      auto independent_result = read_file(independent_input);
+
+      auto scarp_controls = SCARPProgram(independent_result.graph,
+                                         *costs,
+                                         independent_result.fractional_controls).solve();
+
+      EXPECT_TRUE(controls_are_integral(step_result.graph,
+                                        sequence_controls));
+
+      EXPECT_TRUE(cmp::le(control_distance(step_result.graph,
+                                           step_result.fractional_controls,
+                                           sequence_controls),
+                          upper_bound));
+
+      EXPECT_TRUE(cmp::eq(costs->evaluate(step_result.graph, sequence_controls),
+                          costs->evaluate(independent_result.graph, scarp_controls)));
+    }
+  }
+}
@@ -0,0 +1,60 @@
+#include <gtest/gtest.h>
+
+#include "grid.hh"
+#include "sorted_scarp/sorted_program.hh"
+
+#include "test_fixture.hh"
+
+TEST_F(TestInstances, test_sorted_solve)
+{
+  for(const auto& test_instance : test_instances)
+  {
+    auto result = test_instance.read();
+
+    const Vertex source = *result.graph.get_vertices().begin();
+    const idx dimension = result.fractional_controls(source).size();
+
+    const idx grid_length = compute_grid_length(result.graph,
+                                                result.coordinates);
+
+    const double scale_factor = 1. / ((double) grid_length);
+
+    auto costs = VariationalCosts(scale_factor);
+
+    const double upper_bound = max_control_deviation(dimension);
+
+    for(idx history_length : {(idx) 1, ExactProgram::unbounded_history})
+    {
+      SortedProgram program(result.graph,
+                            costs,
+                            result.fractional_controls,
+                            false,
+                            history_length);
+
+      auto sorted_controls = program.solve();
+
+      const double distance = control_distance(result.graph,
+                                               result.fractional_controls,
+                                               sorted_controls);
+
+      const double control_cost = costs.evaluate(result.graph, sorted_controls);
+
+      EXPECT_TRUE(controls_are_convex(result.graph,
+                                      sorted_controls));
+
+      EXPECT_TRUE(controls_are_integral(result.graph,
+                                        sorted_controls));
+
+      EXPECT_TRUE(cmp::le(distance, upper_bound));
+
+      if(history_length == ExactProgram::unbounded_history)
+      {
+        EXPECT_TRUE(cmp::eq(control_cost, test_instance.get_optimal_objective()));
+      }
+      else
+      {
+        EXPECT_TRUE(cmp::ge(control_cost, test_instance.get_optimal_objective()));
+      }
+    }
+  }
+}
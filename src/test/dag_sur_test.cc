@@ -1,6 +1,13 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <random>
+#include <sstream>
+
 #include "grid.hh"
+#include "local_search.hh"
+#include "sur/batch_sur.hh"
+#include "sur/lookahead_sur.hh"
 #include "sur/sur.hh"
 
 #include "test_fixture.hh"
@@ -43,3 +50,250 @@ TEST_F(TestInstances, test_sur_solve)
     EXPECT_TRUE(cmp::le(distance, upper_bound));
   }
 }
+
+TEST_F(TestInstances, test_stream_sur_solve)
+{
+  for(const auto& test_instance : test_instances)
+  {
+    auto result = test_instance.read();
+
+    const Vertex source = *result.graph.get_vertices().begin();
+    const idx dimension = result.fractional_controls(source).size();
+
+    auto costs = VariationalCosts();
+
+    auto sur_controls = compute_sur_controls(result.graph,
+                                             result.fractional_controls,
+                                             costs);
+
+    fs::ifstream input{test_instance.get_path()};
+    std::stringstream output;
+
+    const double distance = stream_sur_controls(input, output);
+
+    EXPECT_TRUE(cmp::le(distance, max_control_deviation(dimension)));
+
+    EXPECT_TRUE(cmp::eq(distance, control_distance(result.graph,
+                                                   result.fractional_controls,
+                                                   sur_controls)));
+
+    ControlRowReader reader(output);
+
+    Point point;
+    Controls controls;
+
+    for(const Vertex& vertex : result.graph.get_vertices())
+    {
+      ASSERT_TRUE(reader.read(point, controls));
+
+      EXPECT_EQ(point, result.coordinates(vertex));
+      EXPECT_EQ(controls, sur_controls(vertex));
+    }
+
+    EXPECT_FALSE(reader.read(point, controls));
+  }
+}
+
+TEST_F(TestInstances, test_batch_sur_solve)
+{
+  std::vector<ReadResult> results;
+
+  for(const auto& test_instance : test_instances)
+  {
+    results.push_back(test_instance.read());
+  }
+
+  ASSERT_FALSE(results.empty());
+
+  const Vertex source = *results.front().graph.get_vertices().begin();
+  const idx dimension = results.front().fractional_controls(source).size();
+
+  BatchSUR batch_sur(dimension);
+
+  // exceed the size of a single block
+  for(idx repeat = 0; repeat < batch_sur.get_block_size(); ++repeat)
+  {
+    for(const auto& result : results)
+    {
+      if(result.fractional_controls(source).size() == dimension)
+      {
+        batch_sur.add(result.graph, result.fractional_controls);
+      }
+    }
+  }
+
+  const auto batch_controls = batch_sur.solve();
+
+  ASSERT_EQ(batch_controls.size(), batch_sur.get_num_instances());
+
+  idx instance = 0;
+
+  for(idx repeat = 0; repeat < batch_sur.get_block_size(); ++repeat)
+  {
+    for(const auto& result : results)
+    {
+      if(result.fractional_controls(source).size() != dimension)
+      {
+        continue;
+      }
+
+      auto costs = VariationalCosts();
+
+      auto sur_controls = compute_sur_controls(result.graph,
+                                               result.fractional_controls,
+                                               costs);
+
+      auto expanded_controls = expand_controls(result.graph,
+                                               batch_controls[instance++],
+                                               dimension);
+
+      for(const Vertex& vertex : result.graph.get_vertices())
+      {
+        EXPECT_EQ(expanded_controls(vertex), sur_controls(vertex));
+      }
+    }
+  }
+}
+
+TEST(DeviationTree, test_deviation_tree)
+{
+  std::mt19937 generator(0);
+
+  std::uniform_real_distribution<double> value_distribution(-1., 1.);
+
+  for(idx size = 1; size <= 33; ++size)
+  {
+    std::uniform_int_distribution<idx> index_distribution(0, size - 1);
+
+    auto random_range = [&]() -> std::pair<idx, idx>
+      {
+        idx first = index_distribution(generator);
+        idx last = index_distribution(generator);
+
+        return std::make_pair(std::min(first, last), std::max(first, last));
+      };
+
+    std::vector<double> values(size);
+
+    for(double& value : values)
+    {
+      value = value_distribution(generator);
+    }
+
+    DeviationTree tree(values);
+
+    for(idx i = 0; i < 100; ++i)
+    {
+      const auto [add_first, add_last] = random_range();
+      const double value = value_distribution(generator);
+
+      tree.add(add_first, add_last, value);
+
+      for(idx j = add_first; j <= add_last; ++j)
+      {
+        values[j] += value;
+      }
+
+      const auto [first, last] = random_range();
+
+      const auto begin = values.begin() + first;
+      const auto end = values.begin() + last + 1;
+
+      EXPECT_TRUE(cmp::eq(tree.min(first, last), *std::min_element(begin, end)));
+      EXPECT_TRUE(cmp::eq(tree.max(first, last), *std::max_element(begin, end)));
+    }
+  }
+}
+
+TEST_F(TestInstances, test_local_search_improve)
+{
+  idx num_improved = 0;
+
+  for(const auto& test_instance : test_instances)
+  {
+    auto result = test_instance.read();
+
+    const Vertex source = *result.graph.get_vertices().begin();
+    const idx dimension = result.fractional_controls(source).size();
+
+    const idx grid_length = compute_grid_length(result.graph,
+                                                result.coordinates);
+
+    const double scale_factor = 1. / ((double) grid_length);
+
+    auto costs = VariationalCosts(scale_factor);
+
+    auto sur_controls = compute_sur_controls(result.graph,
+                                             result.fractional_controls,
+                                             costs);
+
+    LocalSearch search(result.graph,
+                       costs,
+                       result.fractional_controls);
+
+    auto improved_controls = search.improve(sur_controls);
+
+    EXPECT_TRUE(controls_are_convex(result.graph,
+                                    improved_controls));
+
+    EXPECT_TRUE(controls_are_integral(result.graph,
+                                      improved_controls));
+
+    EXPECT_TRUE(cmp::le(control_distance(result.graph,
+                                         result.fractional_controls,
+                                         improved_controls),
+                        max_control_deviation(dimension)));
+
+    const double sur_objective = costs.evaluate(result.graph, sur_controls);
+    const double improved_objective = costs.evaluate(result.graph, improved_controls);
+
+    EXPECT_TRUE(cmp::le(improved_objective, sur_objective));
+
+    // the SUR controls of the test instances can be improved
+    // locally unless they are already optimal
+    if(cmp::gt(sur_objective, test_instance.get_optimal_objective()))
+    {
+      EXPECT_GT(search.get_num_moves(), 0);
+      EXPECT_TRUE(cmp::lt(improved_objective, sur_objective));
+      ++num_improved;
+    }
+    else
+    {
+      EXPECT_EQ(search.get_num_moves(), 0);
+    }
+  }
+
+  EXPECT_GT(num_improved, 0);
+}
+
+TEST_F(TestInstances, test_lookahead_sur_solve)
+{
+  for(const auto& test_instance : test_instances)
+  {
+    auto result = test_instance.read();
+
+    const Vertex source = *result.graph.get_vertices().begin();
+    const idx dimension = result.fractional_controls(source).size();
+
+    auto costs = VariationalCosts();
+
+    for(idx window = 1; window <= 3; ++window)
+    {
+      auto lookahead_controls = compute_lookahead_sur_controls(result.graph,
+                                                               result.fractional_controls,
+                                                               costs,
+                                                               window);
+
+      EXPECT_TRUE(controls_are_convex(result.graph,
+                                      lookahead_controls));
+
+      EXPECT_TRUE(controls_are_integral(result.graph,
+                                        lookahead_controls));
+
+      EXPECT_TRUE(cmp::le(control_distance(result.graph,
+                                           result.fractional_controls,
+                                           lookahead_controls),
+                          max_control_deviation(dimension)));
+    }
+  }
+}
@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+
+#include "grid.hh"
+#include "exact_scarp/table_program.hh"
+
+#include "test_fixture.hh"
+
+TEST_F(TestInstances, test_table_solve)
+{
+  idx num_solved = 0;
+
+  for(const auto& test_instance : test_instances)
+  {
+    auto result = test_instance.read();
+
+    ASSERT_TRUE(compute_sweep_slots(result.graph,
+                                    result.coordinates));
+
+    const Vertex source = *result.graph.get_vertices().begin();
+    const idx dimension = result.fractional_controls(source).size();
+
+    const idx grid_length = compute_grid_length(result.graph,
+                                                result.coordinates);
+
+    const double scale_factor = 1. / ((double) grid_length);
+
+    auto costs = VariationalCosts(scale_factor);
+
+    std::optional<TableProgram> program;
+
+    try
+    {
+      program.emplace(result.graph,
+                      costs,
+                      result.fractional_controls,
+                      result.coordinates);
+    }
+    catch(const std::invalid_argument&)
+    {
+      // too many states
+      continue;
+    }
+
+    auto table_controls = program->solve();
+
+    const double upper_bound = max_control_deviation(dimension);
+
+    const double distance = control_distance(result.graph,
+                                             result.fractional_controls,
+                                             table_controls);
+
+    const double control_cost = costs.evaluate(result.graph, table_controls);
+
+    EXPECT_TRUE(controls_are_convex(result.graph,
+                                    table_controls));
+
+    EXPECT_TRUE(controls_are_integral(result.graph,
+                                      table_controls));
+
+    EXPECT_TRUE(cmp::le(distance, upper_bound));
+
+    EXPECT_TRUE(cmp::eq(control_cost, test_instance.get_optimal_objective()));
+
+    ++num_solved;
+  }
+
+  // the test instances are small enough to fit the tables
+  EXPECT_GT(num_solved, 0);
+}